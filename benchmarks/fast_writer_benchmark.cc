@@ -0,0 +1,112 @@
+// Jakub Staroń, 2016-2017
+#include <celero/Celero.h>
+
+#include "iterators.h"
+#include "io.h"
+#include "io/fast_writer.h"
+
+CELERO_MAIN
+
+using namespace pcl;
+
+constexpr size_t samples = 10;
+constexpr size_t iterations = 10;
+
+class NumbersPrintFixture : public celero::TestFixture
+{
+public:
+  std::vector<std::pair<int64_t, uint64_t>> getExperimentValues() const override
+  {
+    return {
+        {1000, 0},
+        {1000 * 1000, 0},
+        {10 * 1000 * 1000, 0}
+    };
+  }
+
+  void setUp(int64_t experimentValue) override
+  {
+    constexpr uint32 kMaxNumber = 1000 * 1000 * 1000;
+    numbers.clear();
+    for (auto i: range<uint32>(0, experimentValue))
+      numbers.push_back(pcl::Random32() % kMaxNumber);
+    stream.str(std::string());
+    file = std::tmpfile();
+  }
+
+  void tearDown() override
+  {
+    std::fclose(file);
+  }
+
+  std::vector<uint32> numbers;
+  std::ostringstream stream;
+  std::FILE* file;
+};
+
+
+BASELINE_F(PrintLines, Ostringstream, NumbersPrintFixture, samples, iterations)
+{
+  for (auto n: numbers)
+    print(stream, "%0", n);
+  celero::DoNotOptimizeAway(stream.tellp());
+}
+
+BENCHMARK_F(PrintLines, FastWriterStream, NumbersPrintFixture, samples, iterations)
+{
+  FastWriter writer(stream);
+  for (auto n: numbers)
+    print(writer, "%0", n);
+  writer.flush();
+  celero::DoNotOptimizeAway(stream.tellp());
+}
+
+BENCHMARK_F(PrintLines, FastWriterFile, NumbersPrintFixture, samples, iterations)
+{
+  FastWriter writer(file);
+  for (auto n: numbers)
+    writer << n << newline;
+  writer.flush();
+  celero::DoNotOptimizeAway(std::ftell(file));
+}
+
+BENCHMARK_F(PrintLines, FastWriterFileAsynchronous, NumbersPrintFixture, samples, iterations)
+{
+  FastWriter writer(file, writer_mode::asynchronous);
+  for (auto n: numbers)
+    writer << n << newline;
+  writer.flush();
+  celero::DoNotOptimizeAway(std::ftell(file));
+}
+
+BASELINE_F(PrintFormat, RuntimeFormat, NumbersPrintFixture, samples, iterations)
+{
+  FastWriter writer(file);
+  for (auto n: numbers)
+    print(writer, "value = %0, again %0", n);
+  writer.flush();
+  celero::DoNotOptimizeAway(std::ftell(file));
+}
+
+BENCHMARK_F(PrintFormat, CompileTimeFormat, NumbersPrintFixture, samples, iterations)
+{
+  FastWriter writer(file);
+  for (auto n: numbers)
+    print(writer, PCL_FORMAT("value = %0, again %0"), n);
+  writer.flush();
+  celero::DoNotOptimizeAway(std::ftell(file));
+}
+
+BASELINE_F(PrintVector, Ostringstream, NumbersPrintFixture, samples, iterations)
+{
+  stream << numbers << newline;
+  celero::DoNotOptimizeAway(stream.tellp());
+}
+
+BENCHMARK_F(PrintVector, FastWriterStream, NumbersPrintFixture, samples, iterations)
+{
+  FastWriter writer(stream);
+  writer << numbers << newline;
+  writer.flush();
+  celero::DoNotOptimizeAway(stream.tellp());
+}
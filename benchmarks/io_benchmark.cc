@@ -3,6 +3,8 @@
 
 #include "data_structures/indexer.h"
 #include "iterators.h"
+#include "io/fast_reader.h"
+#include "io/mapped_file.h"
 
 CELERO_MAIN
 
@@ -27,7 +29,7 @@ public:
   {
     N = experimentValue;
     constexpr uint32 kMaxNumber = 1000 * 1000 * 1000;
-    std::string string;
+    string.clear();
     for (auto i: range<uint32>(0, experimentValue)) {
       string += std::to_string(pcl::Random32() % kMaxNumber);
       string += '\n';
@@ -35,13 +37,35 @@ public:
     stream.str(string);
   }
 
+  std::string string;
   std::istringstream stream;
   uint32 N;
 };
 
+class NumbersFileLoadFixture : public NumbersLoadFixture
+{
+public:
+  void setUp(int64_t experimentValue) override
+  {
+    NumbersLoadFixture::setUp(experimentValue);
+    file = std::tmpfile();
+    std::fwrite(string.data(), 1, string.size(), file);
+    std::rewind(file);
+  }
+
+  void tearDown() override
+  {
+    std::fclose(file);
+  }
+
+  std::FILE* file;
+};
+
 
 BASELINE_F(Load, Istringstream, NumbersLoadFixture, samples, iterations)
 {
+  stream.clear();
+  stream.str(string);
   uint64 sum = 0;
   for (auto i: range<uint32>(0, N)) {
     uint32 k;
@@ -51,3 +75,70 @@ BASELINE_F(Load, Istringstream, NumbersLoadFixture, samples, iterations)
   celero::DoNotOptimizeAway(sum);
 }
 
+BENCHMARK_F(Load, FastReaderMemory, NumbersLoadFixture, samples, iterations)
+{
+  FastReader reader(string.data(), string.data() + string.size());
+  uint64 sum = 0;
+  for (auto i: range<uint32>(0, N)) {
+    uint32 k;
+    reader >> k;
+    sum += k;
+  }
+  celero::DoNotOptimizeAway(sum);
+}
+
+BENCHMARK_F(Load, FastReaderFile, NumbersFileLoadFixture, samples, iterations)
+{
+  std::rewind(file);
+  FastReader reader(file);
+  uint64 sum = 0;
+  for (auto i: range<uint32>(0, N)) {
+    uint32 k;
+    reader >> k;
+    sum += k;
+  }
+  celero::DoNotOptimizeAway(sum);
+}
+
+BASELINE_F(Lines, Istringstream, NumbersFileLoadFixture, samples, iterations)
+{
+  stream.clear();
+  stream.str(string);
+  uint64 length = 0;
+  iterate(Lines(stream), [&length](const std::string& line) {
+    length += line.size();
+  });
+  celero::DoNotOptimizeAway(length);
+}
+
+BENCHMARK_F(Lines, MappedFile, NumbersFileLoadFixture, samples, iterations)
+{
+  MappedFile mapped(fileno(file));
+  uint64 length = 0;
+  iterate(Lines(mapped), [&length](string_slice line) {
+    length += line.size();
+  });
+  celero::DoNotOptimizeAway(length);
+}
+
+BASELINE_F(LoadVector, ReadSequence, NumbersLoadFixture, samples, iterations)
+{
+  FastReader reader(string.data(), string.data() + string.size());
+  auto v = as_vector(ReadSequence<uint32>(reader, N));
+  celero::DoNotOptimizeAway(v.back());
+}
+
+BENCHMARK_F(LoadVector, ReadInto, NumbersLoadFixture, samples, iterations)
+{
+  FastReader reader(string.data(), string.data() + string.size());
+  std::vector<uint32> v;
+  ReadInto(reader, v, N);
+  celero::DoNotOptimizeAway(v.back());
+}
+
+BENCHMARK_F(LoadVector, ReadColumns, NumbersLoadFixture, samples, iterations)
+{
+  FastReader reader(string.data(), string.data() + string.size());
+  auto columns = ReadColumns<uint32_pair>(reader, N / 2);
+  celero::DoNotOptimizeAway(columns.first.back());
+}
@@ -2,7 +2,16 @@
 #include <celero/Celero.h>
 
 #include "iterators.h"
+#include "numeric/big_unsigned.h"
+#include "numeric/dynamic_field.h"
+#include "numeric/field_arrays.h"
+#include "numeric/matrix.h"
+#include "numeric/multiplicative_functions.h"
+#include "numeric/montgomery_field.h"
+#include "numeric/ntt.h"
 #include "numeric/number_theory.h"
+#include "numeric/power_series.h"
+#include "numeric/prime_field.h"
 
 CELERO_MAIN
 
@@ -79,6 +88,71 @@ BENCHMARK_F(Sieve, Linear, SizeFixture, samples, iterations)
   celero::DoNotOptimizeAway(primes[N - 1]);
 }
 
+BENCHMARK_F(Sieve, Segmented, SizeFixture, samples, iterations)
+{
+  auto primes = numeric::Sieve(N);
+  celero::DoNotOptimizeAway(primes[N - 1]);
+}
+
+BASELINE_F(PrimesCount, Eratostenes, SizeFixture, samples, iterations)
+{
+  auto primes = sieve_of_eratostenes(N);
+  celero::DoNotOptimizeAway(std::count(primes.begin(), primes.end(), true));
+}
+
+BENCHMARK_F(PrimesCount, SegmentedStreaming, SizeFixture, samples, iterations)
+{
+  uint32 count = 0;
+  numeric::ForEachPrime(0, N, [&count](uint64) { count++; });
+  celero::DoNotOptimizeAway(count);
+}
+
+BENCHMARK_F(PrimesCount, SegmentedStreamingNear1e12, SizeFixture, samples, iterations)
+{
+  constexpr uint64 lo = 1000uLL * 1000 * 1000 * 1000;
+  uint32 count = 0;
+  numeric::ForEachPrime(lo, lo + N, [&count](uint64) { count++; });
+  celero::DoNotOptimizeAway(count);
+}
+
+BENCHMARK_F(PrimesCount, LucyHedgehog, SizeFixture, samples, iterations)
+{
+  celero::DoNotOptimizeAway(numeric::PrimeCount(N - 1));
+}
+
+class ThreadsFixture : public celero::TestFixture
+{
+public:
+  std::vector<std::pair<int64_t, uint64_t>> getExperimentValues() const override {
+    std::vector<std::pair<int64_t, uint64_t>> result;
+    const uint32 cores = std::max(1u, std::thread::hardware_concurrency());
+    for (uint32 threads = 1; threads < cores; threads *= 2)
+      result.emplace_back(threads, 1);
+    result.emplace_back(cores, 1);
+    return result;
+  }
+
+  void setUp(int64_t experimentValue) override {
+    threads = uint32(experimentValue);
+  }
+
+  uint32 threads;
+};
+
+constexpr uint32 kParallelSieveSize = 1000 * 1000 * 1000;
+
+BASELINE_F(ParallelSieve, PrimeNumbers, ThreadsFixture, samples, iterations)
+{
+  auto primes = numeric::PrimeNumbers(kParallelSieveSize, threads);
+  celero::DoNotOptimizeAway(primes.back());
+}
+
+BENCHMARK_F(ParallelSieve, CountPrimesNear1e10, ThreadsFixture, samples, iterations)
+{
+  constexpr uint64 lo = 10uLL * 1000 * 1000 * 1000;
+  celero::DoNotOptimizeAway(numeric::CountPrimes(lo, lo + kParallelSieveSize, threads));
+}
+
 class NumbersFixture : public celero::TestFixture
 {
 public:
@@ -106,3 +180,663 @@ BASELINE_F(Factorization, Factorize, NumbersFixture, samples, iterations)
   auto v = numeric::Factorize(number);
   celero::DoNotOptimizeAway(v.front() + v.back());
 }
+
+BENCHMARK_F(Factorization, Factorize64, NumbersFixture, samples, iterations)
+{
+  auto v = numeric::Factorize64(number);
+  celero::DoNotOptimizeAway(v.front() + v.back());
+}
+
+BENCHMARK_F(Factorization, Factorize64Semiprime, NumbersFixture, samples, iterations)
+{
+  constexpr uint64 semiprime = 4294967279uLL * 4294967291uLL;
+  auto v = numeric::Factorize64(semiprime);
+  celero::DoNotOptimizeAway(v.front() + v.back());
+}
+
+constexpr uint32 kMaxNumber = 100 * 1000 * 1000;
+
+class SmallNumbersFixture : public celero::TestFixture
+{
+public:
+
+  std::vector<std::pair<int64_t, uint64_t>> getExperimentValues() const override {
+    return {
+        {1000, 1},
+        {1000 * 1000, 1},
+    };
+  }
+
+  void setUp(int64_t experimentValue) override {
+    numbers.clear();
+    for (auto i: range<int64_t>(0, experimentValue))
+      numbers.push_back(pcl::Random32() % (kMaxNumber - 2) + 2);
+  }
+
+  std::vector<uint32> numbers;
+};
+
+BASELINE_F(FactorizationBatch, TrialDivision, SmallNumbersFixture, samples, iterations)
+{
+  uint64 sum = 0;
+  for (auto n: numbers)
+    sum += numeric::Factorize(n).size();
+  celero::DoNotOptimizeAway(sum);
+}
+
+BENCHMARK_F(FactorizationBatch, SmallestPrimeFactorTable, SmallNumbersFixture, samples, iterations)
+{
+  static const numeric::SmallestPrimeFactorTable table(kMaxNumber);
+  std::vector<uint32> factors;
+  uint64 sum = 0;
+  for (auto n: numbers) {
+    table.factorize(n, factors);
+    sum += factors.size();
+  }
+  celero::DoNotOptimizeAway(sum);
+}
+
+/**
+ * Miller-Rabin test with the same witnesses as numeric::IsPrime,
+ * but computing with Multiply64 instead of Montgomery form.
+ */
+bool miller_rabin_multiply64(uint64 p) {
+  constexpr uint64 witnesses[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+  if (p < 2 || p % 2 == 0)
+    return p == 2;
+
+  uint64 odd_factor = p - 1;
+  uint32 exponent = 0;
+  while (odd_factor % 2 == 0) {
+    odd_factor /= 2;
+    exponent++;
+  }
+
+  for (const auto witness: witnesses) {
+    if (p == witness)
+      return true;
+    uint64 x = 1, a = witness, k = odd_factor;
+    while (k > 0) {
+      if (k % 2 != 0)
+        x = numeric::Multiply64(x, a, p);
+      a = numeric::Multiply64(a, a, p);
+      k /= 2;
+    }
+    if (x == 1 || x == p - 1)
+      continue;
+    uint32 i = 1;
+    for (; i < exponent && x != p - 1; i++)
+      x = numeric::Multiply64(x, x, p);
+    if (x != p - 1)
+      return false;
+  }
+  return true;
+}
+
+class LargeNumbersFixture : public celero::TestFixture
+{
+public:
+  std::vector<std::pair<int64_t, uint64_t>> getExperimentValues() const override {
+    return {
+        {1000, 1},
+        {100 * 1000, 1},
+    };
+  }
+
+  void setUp(int64_t experimentValue) override {
+    numbers.clear();
+    for (auto i: range<int64_t>(0, experimentValue))
+      numbers.push_back(pcl::Random64() | (1uLL << 63) | 1);
+  }
+
+  std::vector<uint64> numbers;
+};
+
+BASELINE_F(PrimalityBatch, MillerRabinMultiply64, LargeNumbersFixture, samples, iterations)
+{
+  uint32 count = 0;
+  for (auto n: numbers)
+    count += miller_rabin_multiply64(n);
+  celero::DoNotOptimizeAway(count);
+}
+
+BENCHMARK_F(PrimalityBatch, IsPrime, LargeNumbersFixture, samples, iterations)
+{
+  uint32 count = 0;
+  for (auto n: numbers)
+    count += numeric::IsPrime(n);
+  celero::DoNotOptimizeAway(count);
+}
+
+BENCHMARK_F(PrimalityBatch, IsPrimeBatch, LargeNumbersFixture, samples, iterations)
+{
+  std::unique_ptr<bool[]> prime(new bool[numbers.size()]);
+  numeric::IsPrimeBatch(numbers.data(), numbers.size(), prime.get());
+  celero::DoNotOptimizeAway(prime[numbers.size() - 1]);
+}
+
+BENCHMARK_F(PrimalityBatch, IsPrimeBatchThreads, LargeNumbersFixture, samples, iterations)
+{
+  std::unique_ptr<bool[]> prime(new bool[numbers.size()]);
+  numeric::IsPrimeBatch(numbers.data(), numbers.size(), prime.get(), 0);
+  celero::DoNotOptimizeAway(prime[numbers.size() - 1]);
+}
+
+uint64 euclid_gcd(uint64 a, uint64 b) {
+  while (a != 0) {
+    uint64 t = a;
+    a = b % a;
+    b = t;
+  }
+  return b;
+}
+
+BASELINE_F(GCD, Euclid, LargeNumbersFixture, samples, iterations)
+{
+  uint64 result = 0;
+  for (size_t i = 1; i < numbers.size(); i++)
+    result += euclid_gcd(numbers[i - 1], numbers[i] >> (i % 32));
+  celero::DoNotOptimizeAway(result);
+}
+
+BENCHMARK_F(GCD, Binary, LargeNumbersFixture, samples, iterations)
+{
+  uint64 result = 0;
+  for (size_t i = 1; i < numbers.size(); i++)
+    result += numeric::GCD(numbers[i - 1], numbers[i] >> (i % 32));
+  celero::DoNotOptimizeAway(result);
+}
+
+class ModularFixture : public celero::TestFixture
+{
+public:
+  std::vector<std::pair<int64_t, uint64_t>> getExperimentValues() const override {
+    return {
+        {1000, 1},
+        {1000 * 1000, 1},
+    };
+  }
+
+  void setUp(int64_t experimentValue) override {
+    modulus = uint32_prime1 - uint32(pcl::Random32() % 2); // unknown at compile time
+    numbers.clear();
+    for (auto i: range<int64_t>(0, experimentValue))
+      numbers.push_back(pcl::Random32() % modulus);
+  }
+
+  uint32 modulus;
+  std::vector<uint32> numbers;
+};
+
+// Horner evaluation of polynomial with coefficients numbers at point 259.
+
+BASELINE_F(RuntimeModulus, ModuloOperator, ModularFixture, samples, iterations)
+{
+  uint64 result = 0;
+  for (auto n: numbers)
+    result = (result * 259 + n) % modulus;
+  celero::DoNotOptimizeAway(result);
+}
+
+BENCHMARK_F(RuntimeModulus, DynamicField, ModularFixture, samples, iterations)
+{
+  using field = numeric::dynamic_field<>;
+  field::setModulus(modulus);
+  const field point = 259;
+  field result = 0;
+  for (auto n: numbers)
+    result = result * point + field(n);
+  celero::DoNotOptimizeAway(result);
+}
+
+BENCHMARK_F(RuntimeModulus, PrimeField, ModularFixture, samples, iterations)
+{
+  using field = numeric::prime_field<uint32_prime1>;
+  const field point = 259;
+  field result = 0;
+  for (auto n: numbers)
+    result = result * point + field(n);
+  celero::DoNotOptimizeAway(result);
+}
+
+BASELINE_F(Inverse, PerValue, ModularFixture, samples, iterations)
+{
+  using field = numeric::prime_field<uint32_prime1>;
+  field result = 0;
+  for (auto n: numbers)
+    result += inverse(field(n | 1));
+  celero::DoNotOptimizeAway(result);
+}
+
+BENCHMARK_F(Inverse, BatchInverse, ModularFixture, samples, iterations)
+{
+  using field = numeric::prime_field<uint32_prime1>;
+  std::vector<field> values(numbers.begin(), numbers.end());
+  for (auto& value: values)
+    value += (value == 0);
+  const auto inverses = numeric::BatchInverse(values);
+  celero::DoNotOptimizeAway(inverses.back());
+}
+
+class FieldFixture : public celero::TestFixture
+{
+public:
+  using field = numeric::prime_field<uint32_prime1>;
+  using montgomery = numeric::montgomery_field<uint32_prime1>;
+
+  std::vector<std::pair<int64_t, uint64_t>> getExperimentValues() const override {
+    return {
+        {1000, 1},
+        {1000 * 1000, 1},
+    };
+  }
+
+  void setUp(int64_t experimentValue) override {
+    numbers.clear();
+    for (auto i: range<int64_t>(0, 2 * experimentValue))
+      numbers.push_back(pcl::Random32() % uint32_prime1);
+    fields.assign(numbers.begin(), numbers.end());
+    montgomery_fields.assign(numbers.begin(), numbers.end());
+  }
+
+  template <typename Field>
+  static Field dotProduct(const std::vector<Field>& v) {
+    const size_t half = v.size() / 2;
+    Field result = 0;
+    for (size_t i = 0; i < half; i++)
+      result += v[i] * v[half + i];
+    return result;
+  }
+
+  template <typename Field>
+  static Field powers(const std::vector<Field>& v) {
+    Field result = 1;
+    for (size_t i = 0; i < v.size() && i < 10000; i++)
+      result *= numeric::power(v[i], i * 1000000007uLL);
+    return result;
+  }
+
+  std::vector<uint32> numbers;
+  std::vector<field> fields;
+  std::vector<montgomery> montgomery_fields;
+};
+
+BASELINE_F(FieldDotProduct, ModuloOperator, FieldFixture, samples, iterations)
+{
+  const size_t half = numbers.size() / 2;
+  uint64 result = 0;
+  for (size_t i = 0; i < half; i++)
+    result = (result + uint64(numbers[i]) * numbers[half + i] % uint32_prime1) % uint32_prime1;
+  celero::DoNotOptimizeAway(result);
+}
+
+BENCHMARK_F(FieldDotProduct, PrimeField, FieldFixture, samples, iterations)
+{
+  celero::DoNotOptimizeAway(dotProduct(fields));
+}
+
+BENCHMARK_F(FieldDotProduct, MontgomeryField, FieldFixture, samples, iterations)
+{
+  celero::DoNotOptimizeAway(dotProduct(montgomery_fields));
+}
+
+BENCHMARK_F(FieldDotProduct, FieldArrays, FieldFixture, samples, iterations)
+{
+  const size_t half = fields.size() / 2;
+  celero::DoNotOptimizeAway(numeric::FieldDotProduct(fields.data(), fields.data() + half, half));
+}
+
+BASELINE_F(FieldScaleAdd, PrimeField, FieldFixture, samples, iterations)
+{
+  const size_t half = fields.size() / 2;
+  const field scalar = 123456789;
+  for (size_t i = 0; i < half; i++)
+    fields[half + i] += scalar * fields[i];
+  celero::DoNotOptimizeAway(fields.back());
+}
+
+BENCHMARK_F(FieldScaleAdd, FieldArrays, FieldFixture, samples, iterations)
+{
+  const size_t half = fields.size() / 2;
+  numeric::FieldScaleAdd(fields.data(), field(123456789), fields.data() + half, half);
+  celero::DoNotOptimizeAway(fields.back());
+}
+
+BASELINE_F(FieldPower, PrimeField, FieldFixture, samples, iterations)
+{
+  celero::DoNotOptimizeAway(powers(fields));
+}
+
+BENCHMARK_F(FieldPower, MontgomeryField, FieldFixture, samples, iterations)
+{
+  celero::DoNotOptimizeAway(powers(montgomery_fields));
+}
+
+class PolynomialFixture : public celero::TestFixture
+{
+public:
+  using field = numeric::prime_field<numeric::kNttPrime1>;
+
+  std::vector<std::pair<int64_t, uint64_t>> getExperimentValues() const override {
+    return {
+        {1000, 1},
+        {10 * 1000, 1},
+    };
+  }
+
+  void setUp(int64_t experimentValue) override {
+    lhs.clear();
+    rhs.clear();
+    for (auto i: range<int64_t>(0, experimentValue)) {
+      lhs.push_back(pcl::Random32());
+      rhs.push_back(pcl::Random32());
+    }
+  }
+
+  std::vector<field> lhs;
+  std::vector<field> rhs;
+};
+
+BASELINE_F(Convolution, Naive, PolynomialFixture, samples, iterations)
+{
+  auto result = numeric::detail::naive_convolution(lhs, rhs);
+  celero::DoNotOptimizeAway(result.back());
+}
+
+BENCHMARK_F(Convolution, NumberTheoreticTransform, PolynomialFixture, samples, iterations)
+{
+  auto result = numeric::Convolution(lhs, rhs);
+  celero::DoNotOptimizeAway(result.back());
+}
+
+class BigPolynomialFixture : public PolynomialFixture
+{
+public:
+  std::vector<std::pair<int64_t, uint64_t>> getExperimentValues() const override {
+    return {
+        {1000 * 1000, 1},
+    };
+  }
+
+  void setUp(int64_t experimentValue) override {
+    PolynomialFixture::setUp(experimentValue);
+    numbers.clear();
+    for (auto i: range<int64_t>(0, experimentValue))
+      numbers.push_back(pcl::Random32());
+  }
+
+  std::vector<uint64> numbers;
+};
+
+BASELINE_F(BigConvolution, NumberTheoreticTransform, BigPolynomialFixture, samples, iterations)
+{
+  auto result = numeric::Convolution(lhs, rhs);
+  celero::DoNotOptimizeAway(result.back());
+}
+
+BENCHMARK_F(BigConvolution, ThreePrimesModulo, BigPolynomialFixture, samples, iterations)
+{
+  auto result = numeric::ConvolutionModulo(numbers, numbers, 1000 * 1000 * 1000 + 7);
+  celero::DoNotOptimizeAway(result.back());
+}
+
+class SeriesFixture : public PolynomialFixture
+{
+public:
+  void setUp(int64_t experimentValue) override {
+    PolynomialFixture::setUp(experimentValue);
+    lhs[0] = 1;
+    rhs[0] = 0;
+  }
+};
+
+BASELINE_F(PowerSeries, NaiveInverse, SeriesFixture, samples, iterations)
+{
+  std::vector<field> result(lhs.size());
+  result[0] = 1;
+  for (size_t i = 1; i < lhs.size(); i++) {
+    field sum = 0;
+    for (size_t j = 1; j <= i; j++)
+      sum += lhs[j] * result[i - j];
+    result[i] = 0 - sum;
+  }
+  celero::DoNotOptimizeAway(result.back());
+}
+
+BENCHMARK_F(PowerSeries, SeriesInverse, SeriesFixture, samples, iterations)
+{
+  auto result = numeric::SeriesInverse(lhs, lhs.size());
+  celero::DoNotOptimizeAway(result.back());
+}
+
+BENCHMARK_F(PowerSeries, SeriesLog, SeriesFixture, samples, iterations)
+{
+  auto result = numeric::SeriesLog(lhs, lhs.size());
+  celero::DoNotOptimizeAway(result.back());
+}
+
+BENCHMARK_F(PowerSeries, SeriesExp, SeriesFixture, samples, iterations)
+{
+  auto result = numeric::SeriesExp(rhs, rhs.size());
+  celero::DoNotOptimizeAway(result.back());
+}
+
+class MatrixFixture : public celero::TestFixture
+{
+public:
+  using field = numeric::prime_field<1000 * 1000 * 1000 + 7>;
+  using matrix = numeric::Matrix<field>;
+
+  std::vector<std::pair<int64_t, uint64_t>> getExperimentValues() const override {
+    return {
+        {100, 1},
+        {300, 1},
+    };
+  }
+
+  void setUp(int64_t experimentValue) override {
+    const uint32 size = uint32(experimentValue);
+    lhs = matrix(size, size);
+    rhs = matrix(size, size);
+    for (auto i: range<uint32>(0, size)) {
+      for (auto j: range<uint32>(0, size)) {
+        lhs(i, j) = pcl::Random32();
+        rhs(i, j) = pcl::Random32();
+      }
+    }
+  }
+
+  matrix lhs = matrix(0, 0);
+  matrix rhs = matrix(0, 0);
+};
+
+BASELINE_F(MatrixMultiply, Naive, MatrixFixture, samples, iterations)
+{
+  const uint32 size = lhs.rows();
+  matrix result(size, size);
+  for (auto i: range<uint32>(0, size))
+    for (auto j: range<uint32>(0, size))
+      for (auto k: range<uint32>(0, size))
+        result(i, j) += lhs(i, k) * rhs(k, j);
+  celero::DoNotOptimizeAway(result(0, 0));
+}
+
+BENCHMARK_F(MatrixMultiply, BlockedDelayedReduction, MatrixFixture, samples, iterations)
+{
+  auto result = lhs * rhs;
+  celero::DoNotOptimizeAway(result(0, 0));
+}
+
+BENCHMARK_F(MatrixMultiply, Determinant, MatrixFixture, samples, iterations)
+{
+  celero::DoNotOptimizeAway(numeric::Determinant(lhs));
+}
+
+class DiscreteLogFixture : public celero::TestFixture
+{
+public:
+  static constexpr uint32 kSafePrime = 2147483579; /// (p - 1) / 2 is prime
+  static constexpr uint32 kSmoothPrime = 998244353;
+
+  std::vector<std::pair<int64_t, uint64_t>> getExperimentValues() const override {
+    return {
+        {10, 1},
+        {100, 1},
+    };
+  }
+
+  void setUp(int64_t experimentValue) override {
+    safe_targets.clear();
+    smooth_targets.clear();
+    for (auto i: range<int64_t>(0, experimentValue)) {
+      safe_targets.push_back(numeric::PowerModulo32(2, pcl::Random32(), kSafePrime));
+      smooth_targets.push_back(numeric::PowerModulo32(3, pcl::Random32(), kSmoothPrime));
+    }
+  }
+
+  /**
+   * Baby-step giant-step with std::unordered_map rebuilt for every query.
+   */
+  static uint32 unorderedMapLogarithm(uint32 a, uint32 x, uint32 p) {
+    const uint32 steps = uint32(SquareCeiling(p - 1));
+    std::unordered_map<uint32, uint32> baby_steps;
+    uint32 value = 1;
+    for (auto i: range<uint32>(0, steps)) {
+      baby_steps.emplace(value, i);
+      value = numeric::Multiply32(value, a, p);
+    }
+    const uint32 giant_step = numeric::Inverse(value, p);
+    for (auto i: range<uint32>(0, steps)) {
+      auto it = baby_steps.find(x);
+      if (it != baby_steps.end())
+        return it->second + i * steps;
+      x = numeric::Multiply32(x, giant_step, p);
+    }
+    return 0;
+  }
+
+  std::vector<uint32> safe_targets;
+  std::vector<uint32> smooth_targets;
+};
+
+constexpr uint32 DiscreteLogFixture::kSafePrime;
+constexpr uint32 DiscreteLogFixture::kSmoothPrime;
+
+BASELINE_F(DiscreteLogarithm, UnorderedMapPerQuery, DiscreteLogFixture, samples, iterations)
+{
+  for (auto x: safe_targets)
+    celero::DoNotOptimizeAway(unorderedMapLogarithm(2, x, kSafePrime));
+}
+
+BENCHMARK_F(DiscreteLogarithm, Solver, DiscreteLogFixture, samples, iterations)
+{
+  numeric::DiscreteLogSolver solver(2, kSafePrime);
+  for (auto x: safe_targets)
+    celero::DoNotOptimizeAway(solver.logarithm(x));
+}
+
+BENCHMARK_F(DiscreteLogarithm, SolverBigTable, DiscreteLogFixture, samples, iterations)
+{
+  numeric::DiscreteLogSolver solver(2, kSafePrime, 8.0);
+  for (auto x: safe_targets)
+    celero::DoNotOptimizeAway(solver.logarithm(x));
+}
+
+BASELINE_F(DiscreteLogarithmSmooth, UnorderedMapPerQuery, DiscreteLogFixture, samples, iterations)
+{
+  for (auto x: smooth_targets)
+    celero::DoNotOptimizeAway(unorderedMapLogarithm(3, x, kSmoothPrime));
+}
+
+BENCHMARK_F(DiscreteLogarithmSmooth, PohligHellman, DiscreteLogFixture, samples, iterations)
+{
+  numeric::DiscreteLogSolver solver(3, kSmoothPrime);
+  for (auto x: smooth_targets)
+    celero::DoNotOptimizeAway(solver.logarithm(x));
+}
+
+class MultiplicativeFunctionFixture : public celero::TestFixture
+{
+public:
+  std::vector<std::pair<int64_t, uint64_t>> getExperimentValues() const override {
+    return {
+        {1000 * 1000, 1},
+        {10 * 1000 * 1000, 1},
+    };
+  }
+
+  void setUp(int64_t experimentValue) override {
+    n = uint32(experimentValue);
+  }
+
+  uint32 n;
+};
+
+BASELINE_F(Totient, PrimePowersLoops, MultiplicativeFunctionFixture, samples, iterations)
+{
+  // Former implementation from examples/lcm_sum.cc.
+  std::vector<uint32> result(n, 1);
+  result[0] = 0;
+  for (uint64 p: numeric::PrimeNumbers(n)) {
+    for (uint64 q = p; q < n; q *= p) {
+      result[q] = (q / p) * (p - 1);
+      for (uint64 i = 2; i * q < n; i++) {
+        if (divides(p, i))
+          continue;
+        result[i * q] *= result[q];
+      }
+    }
+  }
+  celero::DoNotOptimizeAway(result.back());
+}
+
+BENCHMARK_F(Totient, LinearSieve, MultiplicativeFunctionFixture, samples, iterations)
+{
+  celero::DoNotOptimizeAway(numeric::TotientFunctionValues(n).back());
+}
+
+BENCHMARK_F(Totient, DivisorSumLinearSieve, MultiplicativeFunctionFixture, samples, iterations)
+{
+  celero::DoNotOptimizeAway(numeric::DivisorSumValues(n).back());
+}
+
+class BigUnsignedFixture : public celero::TestFixture
+{
+public:
+  std::vector<std::pair<int64_t, uint64_t>> getExperimentValues() const override {
+    return {
+        {64, 100},
+        {1000, 5},
+        {10 * 1000, 1},
+    };
+  }
+
+  void setUp(int64_t experimentValue) override {
+    a = b = 0;
+    for (auto i: range<int64_t>(0, experimentValue)) {
+      a.multiplyAdd(uint32(Random32()), uint32(Random32()));
+      b.multiplyAdd(uint32(Random32()) | 1, uint32(Random32()));
+    }
+    product.resize(a.limbs().size() + b.limbs().size());
+  }
+
+  numeric::BigUnsigned a, b;
+  std::vector<uint32> product;
+};
+
+BASELINE_F(BigMultiply, Schoolbook, BigUnsignedFixture, samples, iterations)
+{
+  numeric::detail::schoolbook_multiply(a.limbs().data(), a.limbs().size(), b.limbs().data(), b.limbs().size(),
+                                       product.data());
+  celero::DoNotOptimizeAway(product.back());
+}
+
+BENCHMARK_F(BigMultiply, Karatsuba, BigUnsignedFixture, samples, iterations)
+{
+  celero::DoNotOptimizeAway((a * b).limbs().back());
+}
+
+BENCHMARK_F(BigMultiply, DecimalOutput, BigUnsignedFixture, samples, iterations)
+{
+  celero::DoNotOptimizeAway(a.toString().size());
+}
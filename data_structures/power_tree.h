@@ -2,6 +2,7 @@
 // Jakub Staroń, 2016-2017
 
 #include "headers.h"
+#include "io/serialization.h"
 
 namespace pcl {
 
@@ -66,6 +67,22 @@ public:
     return size_type(load_.size());
   }
 
+  /**
+   * Writes tree, see BinaryWriter.
+   */
+  void serialize(BinaryWriter& writer) const {
+    writer.write(load_);
+  }
+
+  /**
+   * Reads tree written by serialize.
+   */
+  static PowerTree deserialize(BinaryReader& reader) {
+    PowerTree result(0);
+    result.load_ = reader.read<std::vector<value_type>>();
+    return result;
+  }
+
 private:
   static index_type step(index_type n) {
     return ((n ^ (n - 1)) + 1) / 2;
@@ -4,6 +4,7 @@
 #include "headers.h"
 #include "iterators.h"
 #include "numeric.h"
+#include "io/serialization.h"
 
 namespace pcl {
 
@@ -41,7 +42,45 @@ public:
     return uint32(values_.size());
   }
 
+  /**
+   * Writes values and preprocessed tables, see BinaryWriter.
+   */
+  void serialize(BinaryWriter& writer) const {
+    writer.write(values_);
+    const size_type levels = (size() == 0)? 0 : most_significant_one(size()) + 1;
+    writer.write(levels);
+    for (auto i: range<size_type>(0, levels))
+      writer.write(segments_[i]);
+  }
+
+  /**
+   * Reads structure written by serialize without preprocessing.
+   */
+  static RangeMinimumQuery deserialize(BinaryReader& reader, Comparator comparator = Comparator()) {
+    RangeMinimumQuery result(comparator);
+    result.values_ = reader.read<std::vector<Value>>();
+    constexpr const char* kInvalidData = "RangeMinimumQuery - invalid serialized data";
+    if (result.values_.size() >= (size_t(1) << kMaximumNumberOfLevels))
+      throw std::runtime_error(kInvalidData);
+    const size_type levels = reader.read<size_type>();
+    if (levels != ((result.size() == 0)? 0 : most_significant_one(result.size()) + 1))
+      throw std::runtime_error(kInvalidData);
+    for (auto i: range<size_type>(0, levels)) {
+      result.segments_[i] = reader.read<std::vector<index_type>>();
+      if (result.segments_[i].size() != result.size() - (1u << i) + 1)
+        throw std::runtime_error(kInvalidData);
+      for (auto index: result.segments_[i]) {
+        if (index >= result.size())
+          throw std::runtime_error(kInvalidData);
+      }
+    }
+    return result;
+  }
+
 private:
+  explicit RangeMinimumQuery(Comparator comparator):
+      comparator_(comparator) { }
+
   void calculate() {
     segments_[0].assign(counting_iterator<uint32>(0), counting_iterator<uint32>(size()));
     const size_type log_size = most_significant_one(size());
@@ -49,7 +88,7 @@ private:
     {
       const size_type segment_length = (1u << i);
       const size_type segments_count = size() - segment_length + 1;
-      segments_[i].reserve(segments_count);
+      segments_[i].resize(segments_count);
       for (auto j : range<index_type>(0, segments_count))
         segments_[i][j] = minimum_index(i - 1, j, j + segment_length / 2);
     }
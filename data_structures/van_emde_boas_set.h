@@ -5,6 +5,7 @@
 #include "operators.h"
 #include "numeric.h"
 #include "iterators/bidirectional_iterator.h"
+#include "io/serialization.h"
 
 namespace pcl {
 
@@ -514,6 +515,30 @@ public:
     return reverse_iterator(this, kEnd);
   }
 
+  /**
+   * Writes set, see BinaryWriter.
+   *
+   * Tree contains no pointers, so it is stored as its memory
+   * image in single block (only on little-endian hosts).
+   */
+  void serialize(BinaryWriter& writer) const {
+    static_assert(detail::kLittleEndianHost, "VanEmdeBoasSet - serialization requires little-endian host");
+    writer.write(uint8(logM)).write(uint32(sizeof(tree_type))).write(size_);
+    writer.writeBytes(tree_.get(), sizeof(tree_type));
+  }
+
+  /**
+   * Reads set written by serialize.
+   */
+  static VanEmdeBoasSet deserialize(BinaryReader& reader) {
+    if (reader.read<uint8>() != logM || reader.read<uint32>() != sizeof(tree_type))
+      throw std::runtime_error("VanEmdeBoasSet - invalid serialized data");
+    VanEmdeBoasSet result;
+    result.size_ = reader.read<size_type>();
+    reader.readBytes(result.tree_.get(), sizeof(tree_type));
+    return result;
+  }
+
 private:
   static constexpr const char kOutOfRange[] = "VanEmdeBoasSet: outOfRange";
   static constexpr const char kIllegalOperation[] = "VanEmdeBoasSet: illegalOperation";
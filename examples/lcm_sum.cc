@@ -4,7 +4,7 @@
 // http://www.spoj.com/problems/LCMSUM/
 
 #include "headers.h"
-#include "numeric/number_theory.h"
+#include "numeric/multiplicative_functions.h"
 #include "logger.h"
 #include "io.h"
 
@@ -12,36 +12,12 @@ using namespace pcl;
 
 logging::Logger logger("main");
 
-/**
- * Returns vector with values of Euler's totient function
- * for k = 0,1,...n-1
- */
-std::vector<uint32> TotientFunctionValues(uint32 N) {
-  std::vector<uint32> result(N, 1);
-  result[0] = 0;
-
-  const auto primes = numeric::PrimeNumbers(N);
-  for (uint64 p: primes) {
-    for (uint64 q = p; q < N; q *= p) {
-      result[q] = (q / p) * (p - 1);
-      for (uint64 i = 2; i * q < N; i++) {
-        if (divides(p, i))
-          continue;
-
-        result[i * q] *= result[q];
-      }
-    }
-  }
-
-  return result;
-}
-
 constexpr uint32 kMaxN = 1000 * 1000;
 
 class Application {
 public:
   Application() {
-    auto totient = TotientFunctionValues(kMaxN + 1);
+    auto totient = numeric::TotientFunctionValues(kMaxN + 1);
 
     sum.assign(kMaxN + 1, 0);
     for (auto d: range<uint64>(1, kMaxN + 1)) {
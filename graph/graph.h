@@ -3,6 +3,7 @@
 
 #include "headers.h"
 #include "iterators.h"
+#include "io/serialization.h"
 
 namespace pcl {
 namespace graph {
@@ -80,6 +81,49 @@ public:
     return size_type(edges_.size());
   }
 
+  /**
+   * Writes graph, see BinaryWriter.
+   *
+   * Vertices and edges are written in bulk, so their data
+   * has to be trivially copyable. Adjacency lists are written
+   * as offsets into single array of edge ids.
+   */
+  void serialize(BinaryWriter& writer) const {
+    std::vector<id_type> offsets;
+    std::vector<id_type> adjacency;
+    offsets.reserve(edges_from_.size() + 1);
+    offsets.push_back(0);
+    for (const auto& edges: edges_from_) {
+      adjacency.insert(adjacency.end(), edges.begin(), edges.end());
+      offsets.push_back(id_type(adjacency.size()));
+    }
+    writer.write(vertices_).write(edges_).write(offsets).write(adjacency);
+  }
+
+  /**
+   * Reads graph written by serialize.
+   */
+  static StaticGraph deserialize(BinaryReader& reader) {
+    StaticGraph result;
+    result.vertices_ = reader.read<std::vector<vertex_type>>();
+    result.edges_ = reader.read<std::vector<edge_type>>();
+    const auto offsets = reader.read<std::vector<id_type>>();
+    const auto adjacency = reader.read<std::vector<id_type>>();
+    if (offsets.size() != result.vertices_.size() + 1 || offsets.back() != adjacency.size())
+      throw std::runtime_error("StaticGraph - invalid serialized data");
+    for (auto edge_id: adjacency) {
+      if (edge_id >= result.edges_.size())
+        throw std::runtime_error("StaticGraph - invalid serialized data");
+    }
+    result.edges_from_.resize(result.vertices_.size());
+    for (auto v: range<size_type>(0, result.vertices_count())) {
+      if (offsets[v] > offsets[v + 1])
+        throw std::runtime_error("StaticGraph - invalid serialized data");
+      result.edges_from_[v].assign(adjacency.begin() + offsets[v], adjacency.begin() + offsets[v + 1]);
+    }
+    return result;
+  }
+
 private:
   void register_edge(id_type edge_id, id_type vertex_id) {
     edges_from_.at(vertex_id).push_back(edge_id);
@@ -3,18 +3,27 @@
 
 #include "headers.h"
 #include "numeric.h"
+#include "numeric/montgomery_field.h"
 #include "numeric/prime_field.h"
 #include "operators.h"
 
 namespace pcl {
 namespace hash {
 
+/**
+ * Type of single component of hash. Both numeric::prime_field
+ * and numeric::montgomery_field can be used here, compare them
+ * with FieldDotProduct benchmark on target machine.
+ */
+template <uint32 prime>
+using hash_field = numeric::prime_field<prime>;
+
 /**
  * Type for storing hash.
  *
  * It's guaranteed that have at least 63 bit space of values.
  */
-using hash_type = std::pair<numeric::prime_field<uint32_prime1>, numeric::prime_field<uint32_prime2>>;
+using hash_type = std::pair<hash_field<uint32_prime1>, hash_field<uint32_prime2>>;
 using scalar_type = uint32;
 
 constexpr hash_type zero{0, 0};
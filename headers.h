@@ -108,6 +108,10 @@ uint64 Random64(uint64 a, uint64 b) {
 #define USE_INT128_TYPES
 #endif
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HAVE_X86_SIMD
+#endif
+
 #ifdef USE_INT128_TYPES
 using int128 = __int128;
 using uint128 = unsigned __int128;
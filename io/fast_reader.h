@@ -0,0 +1,464 @@
+#pragma once
+// Jakub Staroń, 2016-2017
+
+#include "io.h"
+#include "numeric/big_unsigned.h"
+#include "numeric/dynamic_field.h"
+#include "numeric/montgomery_field.h"
+#include "numeric/prime_field.h"
+
+namespace pcl {
+
+namespace detail {
+
+template <typename T>
+struct is_character : std::integral_constant<bool,
+    std::is_same<T, char>::value ||
+    std::is_same<T, signed char>::value ||
+    std::is_same<T, unsigned char>::value> { };
+
+inline bool is_digit(char c) {
+  return uint8(c - '0') < 10;
+}
+
+/**
+ * Parses floating point number from null terminated text.
+ *
+ * Short decimal numbers (at most 15 significant digits and small
+ * exponent) are parsed by hand and exactly, everything else
+ * falls back to std::strtold.
+ *
+ * Returns false if text is not a number.
+ */
+template <typename Floating>
+bool parse_floating(const char* text, Floating& value) {
+  static constexpr double powers[] = {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+  };
+  constexpr uint32 max_exact_digits = 15;
+  constexpr int32 max_exact_exponent = 22;
+
+  const char* it = text;
+  const bool negative = (*it == '-');
+  if (*it == '-' || *it == '+')
+    ++it;
+
+  uint64 mantissa = 0;
+  int32 exponent = 0;
+  uint32 digits = 0;
+  for (; is_digit(*it) && digits <= max_exact_digits; ++it, ++digits)
+    mantissa = mantissa * 10 + uint64(*it - '0');
+
+  if (*it == '.') {
+    for (++it; is_digit(*it) && digits <= max_exact_digits; ++it, ++digits, --exponent)
+      mantissa = mantissa * 10 + uint64(*it - '0');
+  }
+
+  if ((*it == 'e' || *it == 'E') && digits > 0) {
+    ++it;
+    const bool negative_exponent = (*it == '-');
+    if (*it == '-' || *it == '+')
+      ++it;
+    int32 explicit_exponent = 0;
+    for (; is_digit(*it) && explicit_exponent <= max_exact_exponent; ++it)
+      explicit_exponent = explicit_exponent * 10 + (*it - '0');
+    exponent += negative_exponent? -explicit_exponent : explicit_exponent;
+  }
+
+  if (*it != '\0' || digits == 0 || digits > max_exact_digits ||
+      exponent < -max_exact_exponent || exponent > max_exact_exponent) {
+    char* end;
+    const long double result = std::strtold(text, &end);
+    if (end == text)
+      return false;
+    value = Floating(result);
+    return true;
+  }
+
+  double result = double(mantissa);
+  result = (exponent < 0)? result / powers[-exponent] : result * powers[exponent];
+  value = Floating(negative? -result : result);
+  return true;
+}
+
+} // namespace detail
+
+/**
+ * Buffered input reader bypassing std::istream.
+ *
+ * Reads input in big chunks using fread or works directly
+ * on given memory region without copying it. Integers,
+ * floating point numbers, characters and strings are parsed
+ * by hand. Every character not greater than space is treated
+ * as whitespace.
+ *
+ * Mimics std::istream - failed extraction marks reader
+ * as failed and reader converts to false.
+ *
+ * Example:
+ * <pre>
+ * FastReader reader(stdin);
+ * int a, b;
+ * read(reader, a, ignore<int>(), b);
+ * auto v = as_vector(ReadSequence<int>(reader, 10));
+ * </pre>
+ */
+class FastReader {
+public:
+  static constexpr size_t kBufferSize = 1u << 16;
+  static constexpr size_t kMaxNumberLength = 128;
+
+  /**
+   * Constructs reader reading from given file.
+   */
+  explicit FastReader(std::FILE* file):
+      file_(file), buffer_(new char[kBufferSize]),
+      begin_(buffer_.get()), end_(buffer_.get()), failed_(false) { }
+
+  /**
+   * Constructs reader reading from memory range [begin, end).
+   *
+   * Data is not copied, it must outlive reader.
+   */
+  FastReader(const char* begin, const char* end):
+      file_(nullptr), begin_(begin), end_(end), failed_(false) { }
+
+  FastReader(const FastReader&) = delete;
+  FastReader& operator=(const FastReader&) = delete;
+  FastReader(FastReader&&) = default;
+  FastReader& operator=(FastReader&&) = default;
+
+  /**
+   * Returns false if some extraction failed.
+   */
+  explicit operator bool() const {
+    return !failed_;
+  }
+
+  /**
+   * Marks reader as failed, for extraction operators defined outside of class.
+   */
+  void markFailed() {
+    failed_ = true;
+  }
+
+  /**
+   * Returns true if there is no more data to read.
+   */
+  bool eof() {
+    return begin_ == end_ && !refill();
+  }
+
+  /**
+   * Returns next character without extracting it or EOF.
+   */
+  int peek() {
+    return eof()? EOF : int(uint8(*begin_));
+  }
+
+  /**
+   * Extracts next character and returns it or EOF.
+   */
+  int get() {
+    return eof()? EOF : int(uint8(*begin_++));
+  }
+
+  /**
+   * Skips all whitespace characters.
+   */
+  void skipWhitespaces() {
+    do {
+      while (begin_ != end_ && isWhitespace(*begin_))
+        ++begin_;
+    } while (begin_ == end_ && refill());
+  }
+
+  /**
+   * Reads line (without trailing '\n') into given string.
+   *
+   * Returns false if there was no data left.
+   */
+  bool getline(std::string& line) {
+    line.clear();
+    if (eof())
+      return false;
+    do {
+      const char* it = static_cast<const char*>(std::memchr(begin_, '\n', size_t(end_ - begin_)));
+      if (it != nullptr) {
+        line.append(begin_, it);
+        begin_ = it + 1;
+        return true;
+      }
+      line.append(begin_, end_);
+      begin_ = end_;
+    } while (refill());
+    return true;
+  }
+
+  FastReader& operator>>(bool& value) {
+    uint32 n;
+    if (*this >> n)
+      value = (n != 0);
+    return *this;
+  }
+
+  template <typename Character>
+  typename std::enable_if<detail::is_character<Character>::value, FastReader&>::type
+  operator>>(Character& value) {
+    skipWhitespaces();
+    if (eof())
+      failed_ = true;
+    else
+      value = Character(*begin_++);
+    return *this;
+  }
+
+  template <typename Integral>
+  typename std::enable_if<
+      std::is_integral<Integral>::value &&
+      !detail::is_character<Integral>::value &&
+      !std::is_same<Integral, bool>::value,
+      FastReader&
+  >::type
+  operator>>(Integral& value) {
+    using unsigned_type = typename std::make_unsigned<Integral>::type;
+    skipWhitespaces();
+    const int sign = peek();
+    if (sign == '-' || sign == '+')
+      ++begin_;
+
+    // Magnitude of negative value can be greater than maximum by one.
+    const unsigned_type limit = unsigned_type(unsigned_type(std::numeric_limits<Integral>::max()) +
+                                              unsigned_type(std::is_signed<Integral>::value && sign == '-'));
+    constexpr size_t safe_digits = std::numeric_limits<Integral>::digits10;
+    unsigned_type result = 0;
+    bool any_digit = false;
+    bool overflow = false;
+    size_t digits = 0;
+    do {
+      const unsigned_type initial = result;
+      const char* it = begin_;
+      while (it != end_ && detail::is_digit(*it)) {
+        result = unsigned_type(result * 10 + unsigned_type(*it - '0'));
+        ++it;
+      }
+      // Only numbers longer than digits10 may not fit, they are parsed again with checks.
+      digits += size_t(it - begin_);
+      if (digits > safe_digits && !overflow) {
+        result = initial;
+        overflow = !appendDigits(result, begin_, it, limit);
+      }
+      any_digit |= (it != begin_);
+      begin_ = it;
+    } while (begin_ == end_ && refill());
+
+    if (!any_digit || overflow)
+      failed_ = true;
+    else
+      value = Integral((sign == '-')? unsigned_type(-result) : result);
+    return *this;
+  }
+
+  template <typename Floating>
+  typename std::enable_if<std::is_floating_point<Floating>::value, FastReader&>::type
+  operator>>(Floating& value) {
+    char token[kMaxNumberLength + 1];
+    const size_t length = readToken(token, kMaxNumberLength);
+    token[length] = '\0';
+    if (length == kMaxNumberLength && !eof() && !isWhitespace(*begin_)) {
+      // Rare long token, rest of it is read into string.
+      std::string text(token, length), rest;
+      *this >> rest;
+      text += rest;
+      if (!detail::parse_floating(text.c_str(), value))
+        failed_ = true;
+      return *this;
+    }
+    if (length == 0 || !detail::parse_floating(token, value))
+      failed_ = true;
+    return *this;
+  }
+
+  FastReader& operator>>(std::string& value) {
+    skipWhitespaces();
+    value.clear();
+    do {
+      const char* it = begin_;
+      while (it != end_ && !isWhitespace(*it))
+        ++it;
+      value.append(begin_, it);
+      begin_ = it;
+    } while (begin_ == end_ && refill());
+
+    if (value.empty())
+      failed_ = true;
+    return *this;
+  }
+
+private:
+  static bool isWhitespace(char c) {
+    return uint8(c) <= uint8(' ');
+  }
+
+  /**
+   * Appends digits from range [begin, end) to value,
+   * returns false if value would exceed limit.
+   */
+  template <typename Unsigned>
+  static bool appendDigits(Unsigned& value, const char* begin, const char* end, Unsigned limit) {
+    for (; begin != end; ++begin) {
+      const Unsigned digit = Unsigned(*begin - '0');
+      if (value > limit / 10 || (value == limit / 10 && digit > limit % 10))
+        return false;
+      value = Unsigned(value * 10 + digit);
+    }
+    return true;
+  }
+
+  /**
+   * Loads next chunk of file into buffer.
+   * Must be called only when buffer is exhausted.
+   */
+  bool refill() {
+    if (file_ == nullptr)
+      return false;
+    const size_t count = std::fread(buffer_.get(), 1, kBufferSize, file_);
+    begin_ = buffer_.get();
+    end_ = begin_ + count;
+    return count > 0;
+  }
+
+  /**
+   * Reads at most max_length non whitespace characters into
+   * buffer, returns number of read characters.
+   */
+  size_t readToken(char* buffer, size_t max_length) {
+    skipWhitespaces();
+    size_t length = 0;
+    do {
+      while (begin_ != end_ && length < max_length && !isWhitespace(*begin_))
+        buffer[length++] = *begin_++;
+    } while (begin_ == end_ && length < max_length && refill());
+    return length;
+  }
+
+  std::FILE* file_;
+  std::unique_ptr<char[]> buffer_;
+  const char* begin_;
+  const char* end_;
+  bool failed_;
+};
+
+constexpr size_t FastReader::kBufferSize;
+constexpr size_t FastReader::kMaxNumberLength;
+
+/**
+ * Overload operator>> for FastReader and pair.
+ */
+template <typename T1, typename T2>
+FastReader& operator>>(FastReader& reader, std::pair<T1, T2>& pair) {
+  return reader >> pair.first >> pair.second;
+}
+
+/**
+ * Overload operator>> for FastReader and tuple.
+ */
+template <typename... Args>
+FastReader& operator>>(FastReader& reader, std::tuple<Args...>& tuple) {
+  detail::tuple_reader<FastReader, Args...> tuple_reader(reader, tuple);
+  for (auto i: range<size_t>(0, sizeof...(Args))) {
+    tuple_reader.read(i);
+  }
+  return reader;
+}
+
+/**
+ * Second version of overload operator>> for FastReader and tuple.
+ *
+ * Needed to allow constructions like
+ * <pre>
+ * int a, b, c;
+ * reader >> std::tie(a, b, c);
+ * </pre>
+ */
+template <typename... Args>
+FastReader& operator>>(FastReader& reader, std::tuple<Args...>&& tuple) {
+  return reader >> tuple;
+}
+
+/**
+ * Overload operator>> for FastReader and ignore.
+ */
+template <typename T>
+FastReader& operator>>(FastReader& reader, const ignore<T>&) {
+  T ignored;
+  return reader >> ignored;
+}
+
+/**
+ * Overload operator>> for FastReader and prime_field.
+ */
+template <uint32 prime>
+FastReader& operator>>(FastReader& reader, numeric::prime_field<prime>& value) {
+  int64 n;
+  if (reader >> n)
+    value = numeric::prime_field<prime>(n);
+  return reader;
+}
+
+/**
+ * Overload operator>> for FastReader and montgomery_field.
+ */
+template <uint32 prime>
+FastReader& operator>>(FastReader& reader, numeric::montgomery_field<prime>& value) {
+  int64 n;
+  if (reader >> n)
+    value = numeric::montgomery_field<prime>(n);
+  return reader;
+}
+
+/**
+ * Overload operator>> for FastReader and dynamic_field.
+ */
+template <typename Tag>
+FastReader& operator>>(FastReader& reader, numeric::dynamic_field<Tag>& value) {
+  int64 n;
+  if (reader >> n)
+    value = numeric::dynamic_field<Tag>(n);
+  return reader;
+}
+
+/**
+ * Overload operator>> for FastReader and BigUnsigned.
+ *
+ * Reads whitespace delimited token, marks reader as failed
+ * if it is not a decimal number.
+ */
+FastReader& operator>>(FastReader& reader, numeric::BigUnsigned& value) {
+  std::string token;
+  if (!(reader >> token))
+    return reader;
+  if (std::all_of(token.begin(), token.end(), detail::is_digit))
+    value = numeric::BigUnsigned(token);
+  else
+    reader.markFailed();
+  return reader;
+}
+
+/**
+ * Python-like read function for FastReader.
+ *
+ * Example:
+ * <pre>
+ * int a, b;
+ * read(reader, a, ignore<int>(), b);
+ * </pre>
+ */
+template <typename... Args>
+void read(FastReader& reader, Args&&... args) {
+  auto tuple = std::make_tuple(std::ref(args)...);
+  reader >> tuple;
+}
+
+} // namespace pcl
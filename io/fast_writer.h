@@ -0,0 +1,572 @@
+#pragma once
+// Jakub Staroń, 2016-2017
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "io.h"
+#include "numeric/big_unsigned.h"
+#include "numeric/dynamic_field.h"
+#include "numeric/montgomery_field.h"
+#include "numeric/prime_field.h"
+#include "utils/string_slice.h"
+
+namespace pcl {
+
+namespace detail {
+
+constexpr char kDigitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/**
+ * Writes decimal representation of n ending just before
+ * given position. Returns pointer to first written character.
+ *
+ * Uses table of digit pairs, ie one division per two digits.
+ */
+inline char* format_unsigned(uint64 n, char* end) {
+  while (n >= 100) {
+    const uint32 pair = uint32(n % 100) * 2;
+    n /= 100;
+    *--end = kDigitPairs[pair + 1];
+    *--end = kDigitPairs[pair];
+  }
+  if (n >= 10) {
+    const uint32 pair = uint32(n) * 2;
+    *--end = kDigitPairs[pair + 1];
+    *--end = kDigitPairs[pair];
+  }
+  else {
+    *--end = char('0' + n);
+  }
+  return end;
+}
+
+/**
+ * Writes count characters to file, or to stream if file is null.
+ */
+inline void write_output(std::FILE* file, std::ostream* stream, const char* data, size_t count) {
+  if (file != nullptr)
+    std::fwrite(data, 1, count, file);
+  else
+    stream->write(data, count);
+}
+
+/**
+ * Background thread writing buffers submitted by FastWriter.
+ *
+ * At most one buffer is written at a time. Submitted buffer
+ * must not be modified until wait() returns.
+ */
+class output_thread {
+public:
+  output_thread(std::FILE* file, std::ostream* stream):
+      file_(file), stream_(stream), data_(nullptr), count_(0),
+      busy_(false), stop_(false), thread_([this] { run(); }) { }
+
+  output_thread(const output_thread&) = delete;
+  output_thread& operator=(const output_thread&) = delete;
+
+  ~output_thread() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    ready_.notify_one();
+    thread_.join();
+  }
+
+  /**
+   * Blocks until previously submitted buffer is written.
+   */
+  void wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return !busy_; });
+  }
+
+  /**
+   * Waits for previous buffer and starts writing given one.
+   */
+  void submit(const char* data, size_t count) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return !busy_; });
+    data_ = data;
+    count_ = count;
+    busy_ = true;
+    lock.unlock();
+    ready_.notify_one();
+  }
+
+private:
+  void run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      ready_.wait(lock, [this] { return busy_ || stop_; });
+      if (!busy_)
+        return;
+      lock.unlock();
+      write_output(file_, stream_, data_, count_);
+      lock.lock();
+      busy_ = false;
+      done_.notify_one();
+    }
+  }
+
+  std::FILE* file_;
+  std::ostream* stream_;
+  const char* data_;
+  size_t count_;
+  bool busy_;
+  bool stop_;
+  std::mutex mutex_;
+  std::condition_variable ready_;
+  std::condition_variable done_;
+  std::thread thread_;
+};
+
+} // namespace detail
+
+/**
+ * Output mode of FastWriter.
+ *
+ * In asynchronous mode writer fills one buffer while background
+ * thread writes the other one to the file or stream.
+ */
+enum class writer_mode {
+  synchronous,
+  asynchronous
+};
+
+/**
+ * Buffered output writer bypassing std::ostream formatting.
+ *
+ * Collects output in big buffer and passes it to file
+ * (or std::ostream) only when buffer is full or on flush.
+ * Integers are formatted by hand.
+ *
+ * Writer understands pcl::flush, pcl::newline, pcl::simple,
+ * pcl::fancy, std::endl and std::flush, so it can be used
+ * as drop-in replacement of std::ostream in print
+ * and operator<< calls. Buffer is flushed on destruction.
+ *
+ * In writer_mode::asynchronous full buffers are written by
+ * background thread, so computation does not stall on output.
+ * Underlying file or stream must not be used directly until
+ * flush (or pcl::flush), which waits for pending output.
+ *
+ * Example:
+ * <pre>
+ * FastWriter writer(stdout);
+ * writer << fancy << std::make_pair(1, 2) << newline;
+ * print(writer, "%0 %1", 42, std::vector<int>{1, 2, 3});
+ *
+ * FastWriter async(stdout, writer_mode::asynchronous);
+ * </pre>
+ */
+class FastWriter {
+public:
+  static constexpr size_t kBufferSize = 1u << 16;
+  static constexpr size_t kMaxIntegerLength = 24;
+
+  /**
+   * Constructs writer writing to given file.
+   */
+  explicit FastWriter(std::FILE* file, writer_mode mode = writer_mode::synchronous):
+      FastWriter(file, nullptr, mode) { }
+
+  /**
+   * Constructs writer writing to given std::ostream.
+   */
+  explicit FastWriter(std::ostream& stream, writer_mode mode = writer_mode::synchronous):
+      FastWriter(nullptr, &stream, mode) { }
+
+  FastWriter(const FastWriter&) = delete;
+  FastWriter& operator=(const FastWriter&) = delete;
+
+  ~FastWriter() {
+    flush();
+  }
+
+  /**
+   * Writes buffer content to underlying file or stream and flushes it.
+   *
+   * In asynchronous mode waits until all output is written.
+   */
+  void flush() {
+    drain();
+    synchronize();
+    if (file_ != nullptr)
+      std::fflush(file_);
+    else
+      stream_->flush();
+  }
+
+  /**
+   * Writes single character.
+   */
+  FastWriter& put(char c) {
+    reserve(1);
+    *end_++ = c;
+    return *this;
+  }
+
+  /**
+   * Writes count characters starting from data.
+   */
+  FastWriter& write(const char* data, size_t count) {
+    if (count > kBufferSize) {
+      drain();
+      synchronize();
+      sink(data, count);
+      return *this;
+    }
+    reserve(count);
+    std::memcpy(end_, data, count);
+    end_ += count;
+    return *this;
+  }
+
+  /**
+   * Sets printing mode, see pcl::simple and pcl::fancy.
+   */
+  void setFancy(bool fancy) {
+    fancy_ = fancy;
+  }
+
+  /**
+   * Returns true if printing mode is fancy.
+   */
+  bool fancy() const {
+    return fancy_;
+  }
+
+  /**
+   * Sets number of digits after decimal point printed for
+   * floating point numbers. By default they are printed
+   * like std::ostream does (six significant digits).
+   */
+  void setPrecision(uint32 precision) {
+    precision_ = int32(precision);
+  }
+
+  FastWriter& operator<<(char c) {
+    return put(c);
+  }
+
+  FastWriter& operator<<(signed char c) {
+    return put(char(c));
+  }
+
+  FastWriter& operator<<(unsigned char c) {
+    return put(char(c));
+  }
+
+  FastWriter& operator<<(const char* text) {
+    return write(text, std::strlen(text));
+  }
+
+  FastWriter& operator<<(const std::string& text) {
+    return write(text.data(), text.size());
+  }
+
+  FastWriter& operator<<(const string_slice& text) {
+    return write(text.data(), text.size());
+  }
+
+  FastWriter& operator<<(bool value) {
+    return put(value? '1' : '0');
+  }
+
+  template <typename Integral>
+  typename std::enable_if<
+      std::is_integral<Integral>::value &&
+      !std::is_same<Integral, bool>::value &&
+      !std::is_same<Integral, char>::value &&
+      !std::is_same<Integral, signed char>::value &&
+      !std::is_same<Integral, unsigned char>::value,
+      FastWriter&
+  >::type
+  operator<<(Integral value) {
+    using unsigned_type = typename std::make_unsigned<Integral>::type;
+    reserve(kMaxIntegerLength);
+    unsigned_type n = unsigned_type(value);
+    if (value < 0) {
+      *end_++ = '-';
+      n = unsigned_type(0) - n;
+    }
+    char digits[kMaxIntegerLength];
+    char* first = detail::format_unsigned(uint64(n), digits + kMaxIntegerLength);
+    const size_t length = size_t(digits + kMaxIntegerLength - first);
+    std::memcpy(end_, first, length);
+    end_ += length;
+    return *this;
+  }
+
+  template <typename Floating>
+  typename std::enable_if<std::is_floating_point<Floating>::value, FastWriter&>::type
+  operator<<(Floating value) {
+    constexpr size_t max_length = 512;
+    reserve(max_length);
+    const int length = (precision_ < 0)?
+        std::snprintf(end_, max_length, "%g", double(value)) :
+        std::snprintf(end_, max_length, "%.*f", precision_, double(value));
+    if (length > 0)
+      end_ += std::min(size_t(length), max_length - 1);
+    return *this;
+  }
+
+#ifdef USE_INT128_TYPES
+
+  FastWriter& operator<<(uint128 n) {
+    constexpr size_t max_length = 40;
+    char digits[max_length];
+    char* first = digits + max_length;
+    constexpr uint64 ten_to_18 = 1000uLL * 1000 * 1000 * 1000 * 1000 * 1000;
+    while (n >= ten_to_18) {
+      char* chunk_end = first;
+      first = detail::format_unsigned(uint64(n % ten_to_18), chunk_end);
+      while (chunk_end - first < 18)
+        *--first = '0';
+      n /= ten_to_18;
+    }
+    first = detail::format_unsigned(uint64(n), first);
+    return write(first, size_t(digits + max_length - first));
+  }
+
+  FastWriter& operator<<(int128 n) {
+    if (n < 0) {
+      put('-');
+      return *this << uint128(-n);
+    }
+    return *this << uint128(n);
+  }
+
+#endif
+
+  /**
+   * Supports io.h and standard manipulators (see class description).
+   *
+   * Throws std::invalid_argument for other manipulators.
+   */
+  FastWriter& operator<<(std::ostream& (*manipulator)(std::ostream&)) {
+    using manipulator_type = std::ostream& (*)(std::ostream&);
+    if (manipulator == manipulator_type(pcl::newline)) {
+      put('\n');
+    }
+    else if (manipulator == manipulator_type(pcl::flush) ||
+             manipulator == manipulator_type(std::flush<char, std::char_traits<char>>)) {
+      flush();
+    }
+    else if (manipulator == manipulator_type(std::endl<char, std::char_traits<char>>)) {
+      put('\n');
+      flush();
+    }
+    else if (manipulator == manipulator_type(pcl::simple)) {
+      fancy_ = false;
+    }
+    else if (manipulator == manipulator_type(pcl::fancy)) {
+      fancy_ = true;
+    }
+    else {
+      throw std::invalid_argument("FastWriter - unsupported manipulator");
+    }
+    return *this;
+  }
+
+  /**
+   * Formatting flags of std::ios_base are not supported,
+   * deleted to prevent silent conversion to bool.
+   */
+  FastWriter& operator<<(std::ios_base& (*manipulator)(std::ios_base&)) = delete;
+
+private:
+  FastWriter(std::FILE* file, std::ostream* stream, writer_mode mode):
+      file_(file), stream_(stream), buffer_(new char[kBufferSize]),
+      end_(buffer_.get()), fancy_(false), precision_(-1) {
+    if (mode == writer_mode::asynchronous) {
+      spare_.reset(new char[kBufferSize]);
+      thread_.reset(new detail::output_thread(file_, stream_));
+    }
+  }
+
+  /**
+   * Makes sure that at least count bytes are free in buffer.
+   */
+  void reserve(size_t count) {
+    if (size_t(buffer_.get() + kBufferSize - end_) < count)
+      drain();
+  }
+
+  /**
+   * Passes whole buffer content to underlying file or stream.
+   *
+   * In asynchronous mode buffer is handed to background
+   * thread and swapped with the spare one.
+   */
+  void drain() {
+    const size_t count = size_t(end_ - buffer_.get());
+    if (thread_ == nullptr) {
+      sink(buffer_.get(), count);
+    }
+    else if (count > 0) {
+      thread_->submit(buffer_.get(), count);
+      std::swap(buffer_, spare_);
+    }
+    end_ = buffer_.get();
+  }
+
+  /**
+   * Waits for background thread to write submitted buffer.
+   */
+  void synchronize() {
+    if (thread_ != nullptr)
+      thread_->wait();
+  }
+
+  void sink(const char* data, size_t count) {
+    detail::write_output(file_, stream_, data, count);
+  }
+
+  std::FILE* file_;
+  std::ostream* stream_;
+  std::unique_ptr<char[]> buffer_;
+  char* end_;
+  bool fancy_;
+  int32 precision_;
+  std::unique_ptr<char[]> spare_;
+  std::unique_ptr<detail::output_thread> thread_;
+};
+
+constexpr size_t FastWriter::kBufferSize;
+constexpr size_t FastWriter::kMaxIntegerLength;
+
+/**
+ * Overload operator<< for FastWriter and pair.
+ */
+template <typename T1, typename T2>
+FastWriter& operator<<(FastWriter& writer, const std::pair<T1, T2>& pair);
+
+/**
+ * Overload operator<< for FastWriter and tuple.
+ */
+template <typename... Args>
+FastWriter& operator<<(FastWriter& writer, const std::tuple<Args...>& tuple);
+
+/**
+ * Overload operator<< for FastWriter and every iterable (eg vector, map, array).
+ */
+template <typename Iterable>
+typename std::enable_if<detail::allow_print_operator<Iterable>(), FastWriter&>::type
+operator<<(FastWriter& writer, const Iterable& iterable);
+
+template <typename T1, typename T2>
+FastWriter& operator<<(FastWriter& writer, const std::pair<T1, T2>& pair) {
+  detail::delimiter_printer printer(writer.fancy());
+  writer << printer.prefix();
+  writer << printer.delimiter() << pair.first;
+  writer << printer.delimiter() << pair.second;
+  writer << printer.postfix();
+  return writer;
+}
+
+template <typename... Args>
+FastWriter& operator<<(FastWriter& writer, const std::tuple<Args...>& tuple) {
+  detail::delimiter_printer delimiter_printer(writer.fancy());
+  detail::tuple_printer<FastWriter, Args...> tuple_printer(writer, tuple);
+  writer << delimiter_printer.prefix();
+  for (auto i: range<size_t>(0, sizeof...(Args))) {
+    writer << delimiter_printer.delimiter();
+    tuple_printer.print(i);
+  }
+  writer << delimiter_printer.postfix();
+  return writer;
+}
+
+template <typename Iterable>
+typename std::enable_if<detail::allow_print_operator<Iterable>(), FastWriter&>::type
+operator<<(FastWriter& writer, const Iterable& iterable) {
+  detail::delimiter_printer printer(writer.fancy());
+  writer << printer.prefix();
+  for (const auto& elem: iterable) {
+    writer << printer.delimiter() << elem;
+  }
+  writer << printer.postfix();
+  return writer;
+}
+
+/**
+ * Overload operator<< for FastWriter and prime_field.
+ */
+template <uint32 prime>
+FastWriter& operator<<(FastWriter& writer, const numeric::prime_field<prime>& value) {
+  return writer << value.value();
+}
+
+/**
+ * Overload operator<< for FastWriter and montgomery_field.
+ */
+template <uint32 prime>
+FastWriter& operator<<(FastWriter& writer, const numeric::montgomery_field<prime>& value) {
+  return writer << value.value();
+}
+
+/**
+ * Overload operator<< for FastWriter and dynamic_field.
+ */
+template <typename Tag>
+FastWriter& operator<<(FastWriter& writer, const numeric::dynamic_field<Tag>& value) {
+  return writer << value.value();
+}
+
+/**
+ * Overload operator<< for FastWriter and BigUnsigned.
+ *
+ * Digits are written straight from base 10^9 chunks, without building string.
+ */
+FastWriter& operator<<(FastWriter& writer, const numeric::BigUnsigned& value) {
+  const auto chunks = value.decimalChunks();
+  if (chunks.empty())
+    return writer.put('0');
+  writer << chunks.back();
+  char digits[numeric::detail::kDecimalChunkDigits];
+  char* const end = digits + numeric::detail::kDecimalChunkDigits;
+  for (size_t i = chunks.size() - 1; i-- > 0; ) {
+    std::fill(digits, detail::format_unsigned(chunks[i], end), '0');
+    writer.write(digits, numeric::detail::kDecimalChunkDigits);
+  }
+  return writer;
+}
+
+/**
+ * Python-like print function for FastWriter.
+ *
+ * Example:
+ * <pre>
+ * print(writer, "1 + 2 = %0, 2 + 3 = %1", 3, 5);
+ * </pre>
+ */
+template <typename... Args>
+void print(FastWriter& writer, const char* format, const Args&... args) {
+  detail::print_impl(writer, format, args...);
+}
+
+/**
+ * Python-like print function for FastWriter with format
+ * parsed at compile time, see PCL_FORMAT.
+ */
+template <typename... Segments, typename... Args>
+void print(FastWriter& writer, detail::format_segments<Segments...> format, const Args&... args) {
+  format.write(writer, std::tie(args...));
+}
+
+} // namespace pcl
@@ -0,0 +1,189 @@
+#pragma once
+// Jakub Staroń, 2016-2017
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "io.h"
+#include "io/fast_reader.h"
+#include "utils/string_slice.h"
+
+namespace pcl {
+
+/**
+ * Read-only memory mapping of whole file (POSIX mmap).
+ *
+ * Gives access to file content without copying it
+ * into user space buffers. Only regular files can be mapped
+ * (no pipes or terminals). Throws std::runtime_error on failure.
+ *
+ * Example:
+ * <pre>
+ * MappedFile file("input.txt");
+ * for (auto line: iterate(Lines(file))) {
+ *   ...
+ * }
+ * </pre>
+ */
+class MappedFile {
+public:
+  /**
+   * Maps file with given path.
+   */
+  explicit MappedFile(const char* path):
+      data_(nullptr), size_(0) {
+    const int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+      throw std::runtime_error("MappedFile - cannot open file");
+    try {
+      map(fd);
+    }
+    catch (...) {
+      ::close(fd);
+      throw;
+    }
+    ::close(fd);
+  }
+
+  /**
+   * Maps file with given file descriptor, eg 0 for redirected stdin.
+   *
+   * Descriptor is not closed.
+   */
+  explicit MappedFile(int fd):
+      data_(nullptr), size_(0) {
+    map(fd);
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  MappedFile(MappedFile&& other):
+      data_(other.data_), size_(other.size_) {
+    other.data_ = nullptr;
+    other.size_ = 0;
+  }
+
+  ~MappedFile() {
+    if (size_ > 0)
+      ::munmap(const_cast<char*>(data_), size_);
+  }
+
+  const char* begin() const {
+    return data_;
+  }
+
+  const char* end() const {
+    return data_ + size_;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  /**
+   * Returns FastReader parsing file content directly from mapping.
+   */
+  FastReader reader() const {
+    return FastReader(begin(), end());
+  }
+
+private:
+  void map(int fd) {
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode))
+      throw std::runtime_error("MappedFile - not a regular file");
+
+    size_ = size_t(info.st_size);
+    if (size_ == 0)
+      return;
+
+    void* data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      size_ = 0;
+      throw std::runtime_error("MappedFile - mmap failed");
+    }
+    ::madvise(data, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const char*>(data);
+  }
+
+  const char* data_;
+  size_t size_;
+};
+
+/**
+ * Returns generator yielding lines from given mapped file.
+ *
+ * Lines are slices of mapping, no memory is allocated
+ * per line. Splits content exactly like Lines(std::istream&).
+ */
+Generator<string_slice> Lines(const MappedFile& file) {
+  class LinesGenerator: public GeneratorBase<string_slice> {
+  public:
+    LinesGenerator(const char* begin, const char* end):
+        it_(begin), end_(end), finished_(false) { }
+
+    Maybe<string_slice> next() final {
+      if (finished_)
+        return Nothing;
+
+      const void* newline = (it_ == end_)? nullptr : std::memchr(it_, '\n', size_t(end_ - it_));
+      const char* line_end = (newline != nullptr)? static_cast<const char*>(newline) : end_;
+      string_slice line(it_, size_t(line_end - it_));
+      if (line_end == end_)
+        finished_ = true;
+      else
+        it_ = line_end + 1;
+      return line;
+    }
+
+  private:
+    const char* it_;
+    const char* end_;
+    bool finished_;
+  };
+
+  return detail::build_generator<LinesGenerator>(file.begin(), file.end());
+}
+
+/**
+ * Returns generator reading given number of
+ * values from given mapped file.
+ *
+ * Values are parsed by FastReader directly from mapping.
+ *
+ * Example:
+ * <pre>
+ * MappedFile file("input.txt");
+ * auto v = as_vector(ReadSequence<int>(file, 10));
+ * </pre>
+ */
+template <typename ValueType>
+auto ReadSequence(MappedFile& file, uint32 count) ->
+Generator<ValueType>
+{
+  class MappedSequenceReader: public GeneratorBase<ValueType> {
+  public:
+    MappedSequenceReader(const MappedFile& file, uint32 count):
+        reader_(file.reader()), count_(count) { }
+
+    Maybe<ValueType> next() final {
+      if (count_ == 0)
+        return Nothing;
+
+      count_--;
+      ValueType value;
+      reader_ >> value;
+      return Just<ValueType>(value);
+    }
+
+  private:
+    FastReader reader_;
+    uint32 count_;
+  };
+  return detail::build_generator<MappedSequenceReader>(file, count);
+}
+
+} // namespace pcl
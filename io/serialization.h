@@ -0,0 +1,414 @@
+#pragma once
+// Jakub Staroń, 2016-2017
+
+#include "headers.h"
+
+namespace pcl {
+
+/**
+ * Version of binary format written by BinaryWriter.
+ *
+ * Must be increased whenever layout of any serialized type changes.
+ */
+constexpr uint32 kSerializationVersion = 1;
+
+namespace detail {
+
+constexpr char kSerializationMagic[4] = {'P', 'C', 'L', 'B'};
+
+/**
+ * Maximal number of bytes allocated at once when reading
+ * container from stream, whose remaining size is unknown.
+ */
+constexpr size_t kSerializationChunk = 1 << 20;
+
+constexpr bool kLittleEndianHost = (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__);
+
+/**
+ * Reverses order of bytes in value.
+ */
+template <typename T>
+T swap_bytes(T value) {
+  char* bytes = reinterpret_cast<char*>(&value);
+  std::reverse(bytes, bytes + sizeof(T));
+  return value;
+}
+
+/**
+ * True for types which are serialized as their memory image,
+ * so vectors of them can be stored and loaded in bulk.
+ */
+template <typename T>
+struct is_raw_serializable: public std::integral_constant<bool,
+    std::is_trivially_copyable<T>::value && !std::is_pointer<T>::value> { };
+
+template <typename T1, typename T2>
+struct is_raw_serializable<std::pair<T1, T2>>: public std::integral_constant<bool,
+    is_raw_serializable<T1>::value && is_raw_serializable<T2>::value &&
+    sizeof(std::pair<T1, T2>) == sizeof(T1) + sizeof(T2)> { };
+
+} // namespace detail
+
+/**
+ * Describes how values of type T are serialized.
+ *
+ * By default T has to provide member function
+ * void serialize(BinaryWriter&) const and static function
+ * T deserialize(BinaryReader&). Specializations exist for
+ * arithmetic and other trivially copyable types, pairs,
+ * strings and vectors.
+ */
+template <typename T, typename Enable = void>
+struct serializer {
+  template <typename Writer>
+  static void write(Writer& writer, const T& value) {
+    value.serialize(writer);
+  }
+
+  template <typename Reader>
+  static T read(Reader& reader) {
+    return T::deserialize(reader);
+  }
+};
+
+/**
+ * Writes values in compact binary format.
+ *
+ * Stream starts with header (magic bytes and kSerializationVersion),
+ * integers are stored in little-endian order. Vectors of trivially
+ * copyable values are written in bulk.
+ *
+ * Example:
+ * <pre>
+ * std::ofstream file("rmq.bin", std::ios::binary);
+ * BinaryWriter writer(file);
+ * writer.write(rmq);
+ * writer.write(std::vector<int>{1, 2, 3});
+ * </pre>
+ */
+class BinaryWriter {
+public:
+  /**
+   * Constructs writer and writes header to given stream.
+   */
+  explicit BinaryWriter(std::ostream& stream):
+      stream_(stream) {
+    writeBytes(detail::kSerializationMagic, sizeof(detail::kSerializationMagic));
+    write(kSerializationVersion);
+  }
+
+  BinaryWriter(const BinaryWriter&) = delete;
+  BinaryWriter& operator=(const BinaryWriter&) = delete;
+
+  /**
+   * Writes given value.
+   */
+  template <typename T>
+  BinaryWriter& write(const T& value) {
+    serializer<T>::write(*this, value);
+    return *this;
+  }
+
+  /**
+   * Writes count bytes starting from data.
+   */
+  BinaryWriter& writeBytes(const void* data, size_t count) {
+    stream_.write(static_cast<const char*>(data), std::streamsize(count));
+    if (!stream_)
+      throw std::runtime_error("BinaryWriter - write failed");
+    return *this;
+  }
+
+private:
+  std::ostream& stream_;
+};
+
+/**
+ * Reads values written by BinaryWriter.
+ *
+ * Throws std::runtime_error when header does not match
+ * or input is truncated. Reader can work directly on memory,
+ * eg on content of MappedFile.
+ *
+ * Example:
+ * <pre>
+ * MappedFile file("rmq.bin");
+ * BinaryReader reader(file.begin(), file.end());
+ * auto rmq = reader.read<RangeMinimumQuery<int>>();
+ * auto v = reader.read<std::vector<int>>();
+ * </pre>
+ */
+class BinaryReader {
+public:
+  /**
+   * Constructs reader reading from given stream and checks header.
+   */
+  explicit BinaryReader(std::istream& stream):
+      stream_(&stream), it_(nullptr), end_(nullptr) {
+    readHeader();
+  }
+
+  /**
+   * Constructs reader reading from memory range [begin, end) and checks header.
+   */
+  BinaryReader(const char* begin, const char* end):
+      stream_(nullptr), it_(begin), end_(end) {
+    readHeader();
+  }
+
+  BinaryReader(const BinaryReader&) = delete;
+  BinaryReader& operator=(const BinaryReader&) = delete;
+
+  /**
+   * Reads value of given type.
+   */
+  template <typename T>
+  T read() {
+    return serializer<T>::read(*this);
+  }
+
+  /**
+   * Reads count bytes into data.
+   */
+  BinaryReader& readBytes(void* data, size_t count) {
+    if (stream_ != nullptr) {
+      stream_->read(static_cast<char*>(data), std::streamsize(count));
+      if (size_t(stream_->gcount()) != count)
+        truncated();
+    }
+    else {
+      if (size_t(end_ - it_) < count)
+        truncated();
+      if (count > 0)
+        std::memcpy(data, it_, count);
+      it_ += count;
+    }
+    return *this;
+  }
+
+  /**
+   * Throws std::runtime_error when memory input has less than count
+   * elements of element_size bytes left. Sizes read from stream can not
+   * be verified up front, so containers are read from it in chunks.
+   */
+  void checkAvailable(uint64 count, size_t element_size) const {
+    if (stream_ == nullptr && count > uint64(end_ - it_) / element_size)
+      throw std::runtime_error("BinaryReader - size exceeds remaining input");
+  }
+
+  /**
+   * Returns how many of count remaining elements of element_size bytes
+   * can be allocated at once: all of them for memory input (verified
+   * by checkAvailable), at most kSerializationChunk bytes for stream.
+   */
+  size_t chunkSize(uint64 count, size_t element_size) const {
+    if (stream_ == nullptr)
+      return size_t(count);
+    return size_t(std::min<uint64>(count, std::max<size_t>(detail::kSerializationChunk / element_size, 1)));
+  }
+
+private:
+  void readHeader() {
+    char magic[sizeof(detail::kSerializationMagic)];
+    readBytes(magic, sizeof(magic));
+    if (!std::equal(magic, magic + sizeof(magic), detail::kSerializationMagic))
+      throw std::runtime_error("BinaryReader - invalid header");
+    if (read<uint32>() != kSerializationVersion)
+      throw std::runtime_error("BinaryReader - unsupported version");
+  }
+
+  [[ noreturn ]] void truncated() const {
+    throw std::runtime_error("BinaryReader - unexpected end of input");
+  }
+
+  std::istream* stream_;
+  const char* it_;
+  const char* end_;
+};
+
+/**
+ * Arithmetic values are stored in little-endian order.
+ */
+template <typename T>
+struct serializer<T, typename std::enable_if<std::is_arithmetic<T>::value>::type> {
+  static void write(BinaryWriter& writer, T value) {
+    if (!detail::kLittleEndianHost)
+      value = detail::swap_bytes(value);
+    writer.writeBytes(&value, sizeof(T));
+  }
+
+  static T read(BinaryReader& reader) {
+    T value;
+    reader.readBytes(&value, sizeof(T));
+    return detail::kLittleEndianHost? value : detail::swap_bytes(value);
+  }
+};
+
+/**
+ * Other trivially copyable values (eg prime_field or pairs of them)
+ * are stored as memory image, only on little-endian hosts.
+ */
+template <typename T>
+struct serializer<T, typename std::enable_if<
+    detail::is_raw_serializable<T>::value && !std::is_arithmetic<T>::value>::type> {
+  static_assert(detail::kLittleEndianHost || sizeof(T) == 0,
+                "serializer - memory image is portable only on little-endian hosts");
+
+  static void write(BinaryWriter& writer, const T& value) {
+    writer.writeBytes(&value, sizeof(T));
+  }
+
+  static T read(BinaryReader& reader) {
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    reader.readBytes(&storage, sizeof(T));
+    return *reinterpret_cast<const T*>(&storage);
+  }
+};
+
+template <typename T1, typename T2>
+struct serializer<std::pair<T1, T2>, typename std::enable_if<
+    !detail::is_raw_serializable<std::pair<T1, T2>>::value>::type> {
+  static void write(BinaryWriter& writer, const std::pair<T1, T2>& value) {
+    writer.write(value.first).write(value.second);
+  }
+
+  static std::pair<T1, T2> read(BinaryReader& reader) {
+    T1 first = reader.read<T1>();
+    return std::pair<T1, T2>(std::move(first), reader.read<T2>());
+  }
+};
+
+template <>
+struct serializer<std::string> {
+  static void write(BinaryWriter& writer, const std::string& value) {
+    writer.write(uint64(value.size()));
+    writer.writeBytes(value.data(), value.size());
+  }
+
+  static std::string read(BinaryReader& reader) {
+    const uint64 size = reader.read<uint64>();
+    reader.checkAvailable(size, 1);
+    std::string value;
+    while (value.size() < size) {
+      const size_t offset = value.size();
+      value.resize(offset + reader.chunkSize(size - offset, 1));
+      reader.readBytes(&value[offset], value.size() - offset);
+    }
+    return value;
+  }
+};
+
+/**
+ * Vector is stored as its size, size of single element
+ * and elements. Elements which are trivially copyable
+ * are written and read in bulk.
+ */
+template <typename T>
+struct serializer<std::vector<T>> {
+  static void write(BinaryWriter& writer, const std::vector<T>& value) {
+    writer.write(uint64(value.size()));
+    writer.write(uint32(sizeof(T)));
+    write(writer, value, detail::is_raw_serializable<T>());
+  }
+
+  static std::vector<T> read(BinaryReader& reader) {
+    const uint64 size = reader.read<uint64>();
+    if (reader.read<uint32>() != sizeof(T))
+      throw std::runtime_error("BinaryReader - element size mismatch");
+    return read(reader, size, detail::is_raw_serializable<T>());
+  }
+
+private:
+  static void write(BinaryWriter& writer, const std::vector<T>& value, std::true_type) {
+    if (detail::kLittleEndianHost) {
+      writer.writeBytes(value.data(), value.size() * sizeof(T));
+      return;
+    }
+    for (const auto& elem: value)
+      writer.write(elem);
+  }
+
+  static void write(BinaryWriter& writer, const std::vector<T>& value, std::false_type) {
+    for (const auto& elem: value)
+      writer.write(elem);
+  }
+
+  static std::vector<T> read(BinaryReader& reader, uint64 size, std::true_type) {
+    if (!detail::kLittleEndianHost)
+      return read(reader, size, std::false_type());
+    reader.checkAvailable(size, sizeof(T));
+    return readBulk(reader, size, std::is_default_constructible<T>());
+  }
+
+  static std::vector<T> readBulk(BinaryReader& reader, uint64 size, std::true_type) {
+    std::vector<T> value;
+    while (value.size() < size) {
+      const size_t offset = value.size();
+      value.resize(offset + reader.chunkSize(size - offset, sizeof(T)));
+      reader.readBytes(value.data() + offset, (value.size() - offset) * sizeof(T));
+    }
+    return value;
+  }
+
+  static std::vector<T> readBulk(BinaryReader& reader, uint64 size, std::false_type) {
+    using storage_type = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+    std::vector<T> value;
+    while (value.size() < size) {
+      const size_t count = reader.chunkSize(size - value.size(), sizeof(T));
+      std::unique_ptr<storage_type[]> storage(new storage_type[count]);
+      reader.readBytes(storage.get(), count * sizeof(T));
+      const T* data = reinterpret_cast<const T*>(storage.get());
+      value.insert(value.end(), data, data + count);
+    }
+    return value;
+  }
+
+  static std::vector<T> read(BinaryReader& reader, uint64 size, std::false_type) {
+    std::vector<T> value;
+    value.reserve(size_t(std::min<uint64>(size, detail::kSerializationChunk / sizeof(T) + 1)));
+    for (uint64 i = 0; i < size; i++)
+      value.push_back(reader.read<T>());
+    return value;
+  }
+};
+
+/**
+ * bit_vector (eg result of Sieve) is stored as its size
+ * and bits packed into 64-bit words.
+ */
+template <>
+struct serializer<bit_vector> {
+  static void write(BinaryWriter& writer, const bit_vector& value) {
+    writer.write(uint64(value.size()));
+    uint64 word = 0;
+    for (size_t i = 0; i < value.size(); i++) {
+      if (value[i])
+        word |= (uint64(1) << (i % 64));
+      if (i % 64 == 63) {
+        writer.write(word);
+        word = 0;
+      }
+    }
+    if (value.size() % 64 != 0)
+      writer.write(word);
+  }
+
+  static bit_vector read(BinaryReader& reader) {
+    const uint64 size = reader.read<uint64>();
+    reader.checkAvailable(size / 64 + (size % 64 != 0), sizeof(uint64));
+    bit_vector value;
+    uint64 word = 0;
+    while (value.size() < size) {
+      const size_t offset = value.size();
+      value.resize(offset + reader.chunkSize(size - offset, 1));
+      for (size_t i = offset; i < value.size(); i++) {
+        if (i % 64 == 0)
+          word = reader.read<uint64>();
+        value[i] = ((word >> (i % 64)) & 1) != 0;
+      }
+    }
+    return value;
+  }
+};
+
+} // namespace pcl
@@ -79,7 +79,8 @@ power(T v, uint64 n, T one) {
     if (n % 2 != 0)
       one *= v;
     n /= 2;
-    v *= v;
+    if (n > 0) // last square would be wasted, expensive eg for matrices
+      v *= v;
   }
   return one;
 }
@@ -98,7 +99,7 @@ inline constexpr uint32 pop_count(uint64 n) {
  * If n is equal to 0 result is undefined.
  */
 inline constexpr uint32 least_significant_one(uint64 n) {
-  return __builtin_ffsll(n) - 1;
+  return __builtin_ctzll(n);
 }
 
 /**
@@ -0,0 +1,617 @@
+#pragma once
+// Jakub Staroń, 2016-2017
+
+#include "headers.h"
+#include "numeric.h"
+
+namespace pcl {
+namespace numeric {
+
+namespace detail {
+
+/**
+ * Numbers of limbs below which multiplication is done by schoolbook method.
+ */
+constexpr size_t kKaratsubaThreshold = 64;
+
+constexpr uint32 kDecimalChunk = 1000 * 1000 * 1000;
+constexpr uint32 kDecimalChunkDigits = 9;
+
+/**
+ * Numbers of limbs (or decimal chunks) below which conversion
+ * to and from decimal is done by quadratic method.
+ */
+constexpr size_t kConversionThreshold = 64;
+
+/**
+ * Adds source[0, size) to target[0, target_size), target_size >= size.
+ * Returns carry out of target.
+ */
+inline uint32 add_limbs(uint32* target, size_t target_size, const uint32* source, size_t size) {
+  uint64 carry = 0;
+  size_t i = 0;
+  for (; i < size; i++) {
+    carry += uint64(target[i]) + source[i];
+    target[i] = uint32(carry);
+    carry >>= 32;
+  }
+  for (; carry != 0 && i < target_size; i++) {
+    carry += target[i];
+    target[i] = uint32(carry);
+    carry >>= 32;
+  }
+  return uint32(carry);
+}
+
+/**
+ * Subtracts source[0, size) from target[0, target_size),
+ * target must be not smaller than source.
+ */
+inline void subtract_limbs(uint32* target, size_t target_size, const uint32* source, size_t size) {
+  uint32 borrow = 0;
+  size_t i = 0;
+  for (; i < size; i++) {
+    const uint64 difference = uint64(target[i]) - source[i] - borrow;
+    target[i] = uint32(difference);
+    borrow = uint32(difference >> 63);
+  }
+  for (; borrow != 0 && i < target_size; i++)
+    borrow = (target[i]-- == 0);
+}
+
+/**
+ * Returns size of limbs[0, size) without leading zero limbs.
+ */
+inline size_t significant_limbs(const uint32* limbs, size_t size) {
+  while (size > 0 && limbs[size - 1] == 0)
+    size--;
+  return size;
+}
+
+/**
+ * Returns sum of x[0, n) and y[0, m) as vector of max(n, m) + 1 limbs.
+ */
+inline std::vector<uint32> sum_limbs(const uint32* x, size_t n, const uint32* y, size_t m) {
+  if (n < m) {
+    std::swap(x, y);
+    std::swap(n, m);
+  }
+  std::vector<uint32> result(x, x + n);
+  result.push_back(add_limbs(result.data(), n, y, m));
+  return result;
+}
+
+/**
+ * Sets result[0, n + m) to product of a[0, n) and b[0, m).
+ */
+inline void schoolbook_multiply(const uint32* a, size_t n, const uint32* b, size_t m, uint32* result) {
+  std::fill(result, result + n + m, 0);
+  for (size_t i = 0; i < n; i++) {
+    const uint64 factor = a[i];
+    uint64 carry = 0;
+    for (size_t j = 0; j < m; j++) {
+      carry += factor * b[j] + result[i + j];
+      result[i + j] = uint32(carry);
+      carry >>= 32;
+    }
+    result[i + m] = uint32(carry);
+  }
+}
+
+/**
+ * Sets result[0, n + m) to product of a[0, n) and b[0, m).
+ *
+ * Uses Karatsuba's method: with a = a0 + a1 X and b = b0 + b1 X,
+ * middle term a0 b1 + a1 b0 is computed as (a0 + a1)(b0 + b1) - a0 b0 - a1 b1,
+ * so three half-size products are needed instead of four.
+ * Complexity is O(n^log2(3)). Very unbalanced products are split
+ * into balanced ones.
+ */
+inline void karatsuba_multiply(const uint32* a, size_t n, const uint32* b, size_t m, uint32* result) {
+  if (n < m) {
+    std::swap(a, b);
+    std::swap(n, m);
+  }
+  if (m < kKaratsubaThreshold) {
+    schoolbook_multiply(a, n, b, m, result);
+    return;
+  }
+
+  if (2 * m <= n) {
+    std::fill(result, result + n + m, 0);
+    std::vector<uint32> product(2 * m);
+    for (size_t i = 0; i < n; i += m) {
+      const size_t length = std::min(m, n - i);
+      karatsuba_multiply(a + i, length, b, m, product.data());
+      add_limbs(result + i, n + m - i, product.data(), length + m);
+    }
+    return;
+  }
+
+  // m > half, so both a1 and b1 are nonempty
+  const size_t half = n / 2;
+  karatsuba_multiply(a, half, b, half, result);
+  karatsuba_multiply(a + half, n - half, b + half, m - half, result + 2 * half);
+
+  const auto a_sum = sum_limbs(a, half, a + half, n - half);
+  const auto b_sum = sum_limbs(b, half, b + half, m - half);
+  std::vector<uint32> middle(a_sum.size() + b_sum.size());
+  karatsuba_multiply(a_sum.data(), a_sum.size(), b_sum.data(), b_sum.size(), middle.data());
+  subtract_limbs(middle.data(), middle.size(), result, 2 * half);
+  subtract_limbs(middle.data(), middle.size(), result + 2 * half, n + m - 2 * half);
+  add_limbs(result + half, n + m - half, middle.data(), significant_limbs(middle.data(), middle.size()));
+}
+
+} // namespace detail
+
+/**
+ * Arbitrary precision unsigned integer.
+ *
+ * Value is stored as vector of 32-bit limbs, least significant first,
+ * without leading zero limbs (zero has no limbs). Multiplication is
+ * schoolbook for small numbers and Karatsuba for big ones.
+ * Division is supported only by single limb, which is enough for
+ * reductions modulo machine words. Conversion to and from decimal
+ * splits number by powers 10^(9 2^k) (divide and conquer), so it
+ * takes O(M(n) log n), where M(n) is cost of multiplication.
+ *
+ * Operations which would give negative result or divide by zero
+ * throw std::invalid_argument.
+ *
+ * Example:
+ * <pre>
+ * BigUnsigned factorial = 1;
+ * for (uint32 i = 2; i <= 100; i++)
+ *   factorial *= i;
+ * print("%0", factorial); // 158 digits
+ * </pre>
+ */
+class BigUnsigned {
+public:
+  using limb_type = uint32;
+
+  BigUnsigned() { }
+
+  BigUnsigned(uint64 value) {
+    for (; value != 0; value >>= 32)
+      limbs_.push_back(uint32(value));
+  }
+
+  /**
+   * Constructs number from its decimal representation.
+   *
+   * Throws std::invalid_argument if text is empty or contains non digit.
+   */
+  explicit BigUnsigned(const std::string& text) {
+    if (text.empty())
+      throw std::invalid_argument("BigUnsigned - invalid decimal number");
+    // Chunks in base 10^9, least significant first.
+    std::vector<uint32> chunks((text.size() + detail::kDecimalChunkDigits - 1) / detail::kDecimalChunkDigits);
+    for (size_t end = text.size(), i = 0; i < chunks.size(); i++, end -= detail::kDecimalChunkDigits) {
+      const size_t begin = (end > detail::kDecimalChunkDigits)? end - detail::kDecimalChunkDigits : 0;
+      for (size_t j = begin; j < end; j++) {
+        const uint32 digit = uint32(uint8(text[j] - '0'));
+        if (digit >= 10)
+          throw std::invalid_argument("BigUnsigned - invalid decimal number");
+        chunks[i] = chunks[i] * 10 + digit;
+      }
+    }
+    std::vector<BigUnsigned> powers;
+    if (chunks.size() > detail::kConversionThreshold)
+      powers.push_back(BigUnsigned(detail::kDecimalChunk));
+    while (!powers.empty() && (size_t(1) << powers.size()) < chunks.size())
+      powers.push_back(powers.back() * powers.back());
+    *this = fromDecimalChunks(chunks.data(), chunks.size(), powers);
+  }
+
+  /**
+   * Returns limbs of number, least significant first.
+   */
+  const std::vector<uint32>& limbs() const {
+    return limbs_;
+  }
+
+  bool isZero() const {
+    return limbs_.empty();
+  }
+
+  /**
+   * Returns number of bits needed to write number, 0 for zero.
+   */
+  uint64 bitLength() const {
+    return limbs_.empty()? 0 : 32 * (limbs_.size() - 1) + most_significant_one(limbs_.back()) + 1;
+  }
+
+  /**
+   * Returns value as uint64.
+   *
+   * Throws std::out_of_range if value does not fit.
+   */
+  uint64 toUint64() const {
+    if (limbs_.size() > 2)
+      throw std::out_of_range("BigUnsigned - value does not fit in uint64");
+    uint64 result = 0;
+    for (size_t i = limbs_.size(); i-- > 0; )
+      result = (result << 32) | limbs_[i];
+    return result;
+  }
+
+  /**
+   * Returns digits of number in base 10^9, least significant first,
+   * empty for zero.
+   *
+   * Number below 10^(9 2^k) is split by 10^(9 2^(k-1)) into two halves,
+   * which are converted recursively. Division uses Barrett reduction,
+   * so it costs a few multiplications. Small numbers are repeatedly
+   * divided by 10^9.
+   */
+  std::vector<uint32> decimalChunks() const {
+    std::vector<uint32> chunks;
+    if (limbs_.size() <= detail::kConversionThreshold) {
+      chunks.reserve(limbs_.size() * 32 / 29 + 1); // 10^9 > 2^29
+      BigUnsigned rest = *this;
+      while (!rest.isZero())
+        chunks.push_back(rest.divide(detail::kDecimalChunk));
+      return chunks;
+    }
+
+    // Number has at most 2 s - 2 limbs, so it is below top^2.
+    std::vector<BigUnsigned> powers(1, BigUnsigned(detail::kDecimalChunk));
+    while (2 * powers.back().limbs_.size() < limbs_.size() + 2)
+      powers.push_back(powers.back() * powers.back());
+    const size_t level = powers.size() - 1;
+    std::vector<BigUnsigned> inverses(level);
+    for (size_t k = level; k-- > 0 && powers[k + 1].limbs_.size() > detail::kConversionThreshold; )
+      inverses[k] = reciprocal(powers[k]);
+
+    // Quotient by top power is usually much shorter than it,
+    // so only top limbs of top power are needed.
+    const BigUnsigned& top = powers[level];
+    const size_t inverse_limbs = std::min(top.limbs_.size(), limbs_.size() - top.limbs_.size() + 3);
+    BigUnsigned low = *this;
+    const BigUnsigned high = divideBarrett(low, top, reciprocal(top.shiftRight(top.limbs_.size() - inverse_limbs)),
+                                           inverse_limbs);
+    chunks.reserve(size_t(2) << level);
+    appendDecimalChunks(std::move(low), level, powers, inverses, chunks);
+    appendDecimalChunks(high, level, powers, inverses, chunks);
+    while (chunks.back() == 0)
+      chunks.pop_back();
+    return chunks;
+  }
+
+  /**
+   * Returns decimal representation of number.
+   */
+  std::string toString() const {
+    const auto chunks = decimalChunks();
+    if (chunks.empty())
+      return "0";
+    std::string result = std::to_string(chunks.back());
+    for (size_t i = chunks.size() - 1; i-- > 0; ) {
+      char digits[detail::kDecimalChunkDigits];
+      for (uint32 j = detail::kDecimalChunkDigits, chunk = chunks[i]; j-- > 0; chunk /= 10)
+        digits[j] = char('0' + chunk % 10);
+      result.append(digits, detail::kDecimalChunkDigits);
+    }
+    return result;
+  }
+
+  /**
+   * Divides number by divisor in place and returns remainder.
+   *
+   * Throws std::invalid_argument if divisor is 0.
+   */
+  uint32 divide(uint32 divisor) {
+    if (divisor == 0)
+      throw std::invalid_argument("BigUnsigned - division by zero");
+    uint64 remainder = 0;
+    for (size_t i = limbs_.size(); i-- > 0; ) {
+      const uint64 current = (remainder << 32) | limbs_[i];
+      limbs_[i] = uint32(current / divisor);
+      remainder = current % divisor;
+    }
+    normalize();
+    return uint32(remainder);
+  }
+
+  /**
+   * Sets number to number * factor + addend.
+   */
+  void multiplyAdd(uint32 factor, uint32 addend) {
+    uint64 carry = addend;
+    for (auto& limb: limbs_) {
+      carry += uint64(limb) * factor;
+      limb = uint32(carry);
+      carry >>= 32;
+    }
+    if (carry != 0)
+      limbs_.push_back(uint32(carry));
+    normalize();
+  }
+
+  friend BigUnsigned operator+(const BigUnsigned& lhs, const BigUnsigned& rhs) {
+    const BigUnsigned& longer = (lhs.limbs_.size() >= rhs.limbs_.size())? lhs : rhs;
+    const BigUnsigned& shorter = (lhs.limbs_.size() >= rhs.limbs_.size())? rhs : lhs;
+    BigUnsigned result = longer;
+    const uint32 carry = detail::add_limbs(result.limbs_.data(), result.limbs_.size(),
+                                           shorter.limbs_.data(), shorter.limbs_.size());
+    if (carry != 0)
+      result.limbs_.push_back(carry);
+    return result;
+  }
+
+  /**
+   * Throws std::invalid_argument if rhs > lhs.
+   */
+  friend BigUnsigned operator-(const BigUnsigned& lhs, const BigUnsigned& rhs) {
+    if (lhs < rhs)
+      throw std::invalid_argument("BigUnsigned - negative result of subtraction");
+    BigUnsigned result = lhs;
+    detail::subtract_limbs(result.limbs_.data(), result.limbs_.size(), rhs.limbs_.data(), rhs.limbs_.size());
+    result.normalize();
+    return result;
+  }
+
+  friend BigUnsigned operator*(const BigUnsigned& lhs, const BigUnsigned& rhs) {
+    BigUnsigned result;
+    if (lhs.isZero() || rhs.isZero())
+      return result;
+    result.limbs_.resize(lhs.limbs_.size() + rhs.limbs_.size());
+    detail::karatsuba_multiply(lhs.limbs_.data(), lhs.limbs_.size(), rhs.limbs_.data(), rhs.limbs_.size(),
+                               result.limbs_.data());
+    result.normalize();
+    return result;
+  }
+
+  /**
+   * Returns floor(lhs / rhs), throws std::invalid_argument if rhs is 0.
+   */
+  friend BigUnsigned operator/(BigUnsigned lhs, uint32 rhs) {
+    lhs.divide(rhs);
+    return lhs;
+  }
+
+  /**
+   * Returns lhs mod rhs, throws std::invalid_argument if rhs is 0.
+   *
+   * Moduli below 2^32 take one division per limb, bigger
+   * ones are reduced bit by bit, as uint128 may be unavailable.
+   */
+  friend uint64 operator%(const BigUnsigned& lhs, uint64 rhs) {
+    if (rhs == 0)
+      throw std::invalid_argument("BigUnsigned - division by zero");
+    uint64 remainder = 0;
+    for (size_t i = lhs.limbs_.size(); i-- > 0; ) {
+      if (rhs >> 32 == 0) {
+        remainder = ((remainder << 32) | lhs.limbs_[i]) % rhs;
+        continue;
+      }
+      for (uint32 bit = 32; bit-- > 0; ) {
+        const uint64 next = (lhs.limbs_[i] >> bit) & 1;
+        // remainder = (2 * remainder + next) mod rhs, without overflow
+        remainder = (remainder >= rhs - remainder)? remainder - (rhs - remainder) : 2 * remainder;
+        remainder = (remainder >= rhs - next)? remainder - (rhs - next) : remainder + next;
+      }
+    }
+    return remainder;
+  }
+
+  void operator+=(const BigUnsigned& rhs) {
+    *this = *this + rhs;
+  }
+
+  void operator-=(const BigUnsigned& rhs) {
+    *this = *this - rhs;
+  }
+
+  void operator*=(const BigUnsigned& rhs) {
+    *this = *this * rhs;
+  }
+
+  void operator/=(uint32 rhs) {
+    divide(rhs);
+  }
+
+  /**
+   * Returns -1, 0 or 1 if lhs is less, equal or greater than rhs.
+   */
+  friend int compare(const BigUnsigned& lhs, const BigUnsigned& rhs) {
+    if (lhs.limbs_.size() != rhs.limbs_.size())
+      return (lhs.limbs_.size() < rhs.limbs_.size())? -1 : 1;
+    for (size_t i = lhs.limbs_.size(); i-- > 0; ) {
+      if (lhs.limbs_[i] != rhs.limbs_[i])
+        return (lhs.limbs_[i] < rhs.limbs_[i])? -1 : 1;
+    }
+    return 0;
+  }
+
+  friend bool operator==(const BigUnsigned& lhs, const BigUnsigned& rhs) {
+    return lhs.limbs_ == rhs.limbs_;
+  }
+
+  friend bool operator!=(const BigUnsigned& lhs, const BigUnsigned& rhs) {
+    return !(lhs == rhs);
+  }
+
+  friend bool operator<(const BigUnsigned& lhs, const BigUnsigned& rhs) {
+    return compare(lhs, rhs) < 0;
+  }
+
+  friend bool operator>(const BigUnsigned& lhs, const BigUnsigned& rhs) {
+    return compare(lhs, rhs) > 0;
+  }
+
+  friend bool operator<=(const BigUnsigned& lhs, const BigUnsigned& rhs) {
+    return compare(lhs, rhs) <= 0;
+  }
+
+  friend bool operator>=(const BigUnsigned& lhs, const BigUnsigned& rhs) {
+    return compare(lhs, rhs) >= 0;
+  }
+
+private:
+  void normalize() {
+    limbs_.resize(detail::significant_limbs(limbs_.data(), limbs_.size()));
+  }
+
+  /**
+   * Returns floor(number / 2^(32 count)).
+   */
+  BigUnsigned shiftRight(size_t count) const {
+    BigUnsigned result;
+    if (count < limbs_.size())
+      result.limbs_.assign(limbs_.begin() + count, limbs_.end());
+    return result;
+  }
+
+  /**
+   * Returns number * 2^(32 count).
+   */
+  BigUnsigned shiftLeft(size_t count) const {
+    BigUnsigned result;
+    if (!isZero()) {
+      result.limbs_.assign(count, 0);
+      result.limbs_.insert(result.limbs_.end(), limbs_.begin(), limbs_.end());
+    }
+    return result;
+  }
+
+  /**
+   * Returns floor(2^(64 s) / divisor), where s is number of limbs of divisor.
+   *
+   * Starting approximation is reciprocal of top half of divisor (or double
+   * for small divisors), which is refined by Newton's iteration
+   * x = x + x (2^(64 s) - divisor x) / 2^(64 s). Single step doubles
+   * number of correct limbs, the last units are fixed one by one.
+   */
+  static BigUnsigned reciprocal(const BigUnsigned& divisor) {
+    const size_t size = divisor.limbs_.size();
+    const BigUnsigned power = BigUnsigned(1).shiftLeft(2 * size);
+    if (size == 1)
+      return power / divisor.limbs_[0];
+
+    BigUnsigned result;
+    if (size < 8) {
+      const uint64 top = (uint64(divisor.limbs_[size - 1]) << 32) | divisor.limbs_[size - 2];
+      const double scaled = 18446744073709551616.0 / double(top) * 2147483648.0; // 2^64 / top * 2^31
+      result = BigUnsigned(uint64(scaled)).shiftLeft(size) / (1u << 31);
+    }
+    else {
+      const size_t high = size / 2 + 2;
+      result = reciprocal(divisor.shiftRight(size - high)).shiftLeft(size - high);
+    }
+
+    const BigUnsigned bound = divisor * BigUnsigned(4);
+    while (true) {
+      const BigUnsigned product = divisor * result;
+      if (product > power) {
+        BigUnsigned excess = product - power;
+        if (excess >= bound) {
+          result -= (result * excess).shiftRight(2 * size);
+          continue;
+        }
+        for (result -= BigUnsigned(1); excess > divisor; result -= BigUnsigned(1))
+          excess -= divisor;
+        return result;
+      }
+      BigUnsigned remainder = power - product;
+      if (remainder >= bound) {
+        result += (result * remainder).shiftRight(2 * size);
+        continue;
+      }
+      for (; remainder >= divisor; result += BigUnsigned(1))
+        remainder -= divisor;
+      return result;
+    }
+  }
+
+  /**
+   * Divides number by divisor using Barrett reduction, number becomes
+   * remainder, returns quotient. Inverse is reciprocal of top h limbs
+   * of divisor, where h = limbs. Either h is size of divisor and
+   * number < divisor^2, or quotient has at most h - 2 limbs.
+   */
+  static BigUnsigned divideBarrett(BigUnsigned& number, const BigUnsigned& divisor, const BigUnsigned& inverse,
+                                   size_t limbs) {
+    const size_t shift = divisor.limbs_.size() - limbs;
+    // Estimate differs from quotient by at most 3.
+    BigUnsigned quotient = (number.shiftRight(shift + limbs - 1) * inverse).shiftRight(limbs + 1);
+    BigUnsigned product = quotient * divisor;
+    while (product > number) {
+      product -= divisor;
+      quotient -= BigUnsigned(1);
+    }
+    number -= product;
+    while (number >= divisor) {
+      number -= divisor;
+      quotient += BigUnsigned(1);
+    }
+    return quotient;
+  }
+
+  /**
+   * Appends exactly 2^level decimal chunks of number < powers[level],
+   * where powers[k] = 10^(9 2^k) and inverses[k] = reciprocal(powers[k]).
+   */
+  static void appendDecimalChunks(BigUnsigned number, size_t level, const std::vector<BigUnsigned>& powers,
+                                  const std::vector<BigUnsigned>& inverses, std::vector<uint32>& chunks) {
+    if (level == 0 || powers[level].limbs_.size() <= detail::kConversionThreshold) {
+      for (size_t i = 0; i < (size_t(1) << level); i++)
+        chunks.push_back(number.divide(detail::kDecimalChunk));
+      return;
+    }
+    const BigUnsigned& divisor = powers[level - 1];
+    const BigUnsigned high = divideBarrett(number, divisor, inverses[level - 1], divisor.limbs_.size());
+    appendDecimalChunks(std::move(number), level - 1, powers, inverses, chunks);
+    appendDecimalChunks(high, level - 1, powers, inverses, chunks);
+  }
+
+  /**
+   * Returns number with given decimal chunks, least significant first,
+   * powers[k] = 10^(9 2^k) must be given for every 2^k < count.
+   */
+  static BigUnsigned fromDecimalChunks(const uint32* chunks, size_t count, const std::vector<BigUnsigned>& powers) {
+    BigUnsigned result;
+    if (count <= detail::kConversionThreshold) {
+      result.limbs_.reserve(count);
+      for (size_t i = count; i-- > 0; )
+        result.multiplyAdd(detail::kDecimalChunk, chunks[i]);
+      return result;
+    }
+    size_t level = 0;
+    while ((size_t(2) << level) < count)
+      level++;
+    const size_t low = size_t(1) << level;
+    result = fromDecimalChunks(chunks + low, count - low, powers) * powers[level];
+    result += fromDecimalChunks(chunks, low, powers);
+    return result;
+  }
+
+  std::vector<uint32> limbs_;
+};
+
+/**
+ * Overload operator<< for ostream and BigUnsigned, prints number in decimal.
+ */
+std::ostream& operator<<(std::ostream& stream, const BigUnsigned& value) {
+  return stream << value.toString();
+}
+
+/**
+ * Overload operator>> for istream and BigUnsigned.
+ *
+ * Reads whitespace delimited token, sets failbit if it is not a decimal number.
+ */
+std::istream& operator>>(std::istream& stream, BigUnsigned& value) {
+  std::string token;
+  if (!(stream >> token))
+    return stream;
+  if (!token.empty() && std::all_of(token.begin(), token.end(), [](char c) { return uint8(c - '0') < 10; }))
+    value = BigUnsigned(token);
+  else
+    stream.setstate(std::ios_base::failbit);
+  return stream;
+}
+
+} // namespace numeric
+} // namespace pcl
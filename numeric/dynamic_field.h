@@ -0,0 +1,278 @@
+#pragma once
+// Jakub Staroń, 2016-2017
+
+#include "headers.h"
+#include "numeric/montgomery.h"
+
+namespace pcl {
+namespace numeric {
+
+/**
+ * Barrett reduction modulo 32-bit number chosen at runtime.
+ *
+ * Replaces division by modulus with multiplication by
+ * precomputed 2^64 / modulus, which is several times cheaper
+ * than 64-bit % when modulus is not known at compile time.
+ *
+ * Example:
+ * <pre>
+ * Barrett32 context(1000000007);
+ * uint32 r = context.reduce(123456789012345uLL); // 123456789012345 % 1000000007
+ * uint32 product = context.multiply(123456789, 987654321);
+ * </pre>
+ */
+class Barrett32 {
+public:
+  /**
+   * Constructs context for given modulus, which must be positive.
+   */
+  explicit constexpr Barrett32(uint32 modulus):
+      modulus_(modulus), factor_(~uint64(0) / modulus) { }
+
+  constexpr uint32 modulus() const {
+    return modulus_;
+  }
+
+  /**
+   * Returns a (mod modulus), for any a.
+   */
+  uint32 reduce(uint64 a) const {
+    // Quotient is underestimated by at most 2.
+    uint64 result = a - detail::multiply_high(a, factor_) * modulus_;
+    if (result >= modulus_)
+      result -= modulus_;
+    if (result >= modulus_)
+      result -= modulus_;
+    return uint32(result);
+  }
+
+  /**
+   * Returns a + b (mod modulus), for a, b smaller than modulus.
+   */
+  uint32 add(uint32 a, uint32 b) const {
+    const uint64 sum = uint64(a) + b;
+    return uint32((sum >= modulus_)? sum - modulus_ : sum);
+  }
+
+  /**
+   * Returns a - b (mod modulus), for a, b smaller than modulus.
+   */
+  uint32 subtract(uint32 a, uint32 b) const {
+    return (a >= b)? a - b : uint32(uint64(a) + modulus_ - b);
+  }
+
+  /**
+   * Returns a * b (mod modulus).
+   */
+  uint32 multiply(uint32 a, uint32 b) const {
+    return reduce(uint64(a) * b);
+  }
+
+private:
+  uint32 modulus_;
+  uint64 factor_; /// floor((2^64 - 1) / modulus)
+};
+
+// Predeclarations
+
+template <typename Tag>
+class dynamic_field;
+
+/**
+ * Returns a^n in Z_modulus.
+ */
+template <typename Tag>
+dynamic_field<Tag> power(dynamic_field<Tag> a, uint64 n);
+
+/**
+ * Returns 1/lhs in Z_modulus.
+ *
+ * Modulus does not have to be prime. Throws an std::runtime_error
+ * if lhs is not inversible (ie is not coprime with modulus).
+ */
+template <typename Tag>
+dynamic_field<Tag> inverse(const dynamic_field<Tag>& lhs);
+
+template <typename Tag>
+std::ostream& operator<<(std::ostream& stream, const dynamic_field<Tag>& lhs);
+
+template <typename Tag>
+std::istream& operator>>(std::istream& stream, dynamic_field<Tag>& lhs);
+
+// Predeclarations End
+
+/**
+ * Integers modulo number chosen at runtime, counterpart of prime_field.
+ *
+ * Modulus is kept in thread-local Barrett32 context shared by all values
+ * of given type, so it has to be set by setModulus before values are
+ * created and values must not be mixed between moduli. Use different
+ * Tag types to work with several moduli at once. Initial modulus is 1.
+ *
+ * Example:
+ * <pre>
+ * struct first_modulus;
+ * using field = dynamic_field<first_modulus>;
+ * field::setModulus(1000000007);
+ * field a = 123, b = -1;
+ * print("%0", a * b / 7);
+ * </pre>
+ */
+template <typename Tag = void>
+class dynamic_field {
+public:
+  dynamic_field():
+      value_(0) { }
+
+  template <typename Integral, typename = typename std::enable_if<std::is_integral<Integral>::value>::type>
+  dynamic_field(Integral value):
+      value_(reduce(value)) { }
+
+  /**
+   * Sets modulus used by this type in current thread.
+   *
+   * Throws std::invalid_argument if modulus is 0.
+   */
+  static void setModulus(uint32 modulus) {
+    if (modulus == 0)
+      throw std::invalid_argument("dynamic_field - modulus must be positive");
+    context() = Barrett32(modulus);
+  }
+
+  static uint32 modulus() {
+    return context().modulus();
+  }
+
+  /**
+   * Returns Barrett32 context for current modulus.
+   */
+  static Barrett32& context() {
+    static thread_local Barrett32 context(1);
+    return context;
+  }
+
+  friend dynamic_field operator+(const dynamic_field& lhs, const dynamic_field& rhs) {
+    return fromReduced(context().add(lhs.value_, rhs.value_));
+  }
+
+  friend dynamic_field operator-(const dynamic_field& lhs, const dynamic_field& rhs) {
+    return fromReduced(context().subtract(lhs.value_, rhs.value_));
+  }
+
+  friend dynamic_field operator*(const dynamic_field& lhs, const dynamic_field& rhs) {
+    return fromReduced(context().multiply(lhs.value_, rhs.value_));
+  }
+
+  friend dynamic_field power <>(dynamic_field a, uint64 n);
+  friend dynamic_field inverse <>(const dynamic_field& lhs);
+
+  /**
+   * Returns lhs/rhs in Z_modulus.
+   */
+  friend dynamic_field operator/(const dynamic_field& lhs, const dynamic_field& rhs) {
+    return lhs * inverse(rhs);
+  }
+
+  void operator+=(const dynamic_field& rhs);
+  void operator-=(const dynamic_field& rhs);
+  void operator*=(const dynamic_field& rhs);
+  void operator/=(const dynamic_field& rhs);
+
+  friend bool operator==(const dynamic_field& lhs, const dynamic_field& rhs) {
+    return lhs.value_ == rhs.value_;
+  }
+
+  friend bool operator!=(const dynamic_field& lhs, const dynamic_field& rhs) {
+    return !(lhs == rhs);
+  }
+
+  /**
+   * Returns conversion of value to uint32.
+   */
+  uint32 value() const {
+    return value_;
+  }
+
+  friend std::ostream& operator<< <>(std::ostream& stream, const dynamic_field& lhs);
+  friend std::istream& operator>> <>(std::istream& stream, dynamic_field& lhs);
+
+private:
+  static dynamic_field fromReduced(uint32 value) {
+    dynamic_field result;
+    result.value_ = value;
+    return result;
+  }
+
+  template <typename Integral>
+  static typename std::enable_if<std::is_unsigned<Integral>::value, uint32>::type
+  reduce(Integral value) {
+    return context().reduce(value);
+  }
+
+  template <typename Integral>
+  static typename std::enable_if<std::is_signed<Integral>::value, uint32>::type
+  reduce(Integral value) {
+    const Barrett32& barrett = context();
+    if (value >= 0)
+      return barrett.reduce(uint64(value));
+    return barrett.subtract(0, barrett.reduce(uint64(0) - uint64(value)));
+  }
+
+  uint32 value_;
+};
+
+template <typename Tag>
+dynamic_field<Tag> power(dynamic_field<Tag> a, uint64 n) {
+  dynamic_field<Tag> result = 1;
+  while (n > 0) {
+    if (n % 2 == 1)
+      result *= a;
+    a *= a;
+    n /= 2;
+  }
+  return result;
+}
+
+template <typename Tag>
+dynamic_field<Tag> inverse(const dynamic_field<Tag>& lhs) {
+  const uint32 modulus = dynamic_field<Tag>::modulus();
+  if (lhs.value_ == 0 && modulus != 1)
+    throw std::runtime_error("dynamic_field - inverse of zero");
+  return detail::inverse_modulo(lhs.value_, modulus);
+}
+
+template <typename Tag>
+void dynamic_field<Tag>::operator+=(const dynamic_field<Tag>& rhs) {
+  *this = *this + rhs;
+}
+
+template <typename Tag>
+void dynamic_field<Tag>::operator-=(const dynamic_field<Tag>& rhs) {
+  *this = *this - rhs;
+}
+
+template <typename Tag>
+void dynamic_field<Tag>::operator*=(const dynamic_field<Tag>& rhs) {
+  *this = *this * rhs;
+}
+
+template <typename Tag>
+void dynamic_field<Tag>::operator/=(const dynamic_field<Tag>& rhs) {
+  *this = *this / rhs;
+}
+
+template <typename Tag>
+std::ostream& operator<<(std::ostream& stream, const dynamic_field<Tag>& lhs) {
+  return stream << lhs.value_;
+}
+
+template <typename Tag>
+std::istream& operator>>(std::istream& stream, dynamic_field<Tag>& lhs) {
+  int64 value;
+  stream >> value;
+  lhs = dynamic_field<Tag>(value);
+  return stream;
+}
+
+} // namespace numeric
+} // namespace pcl
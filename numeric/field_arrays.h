@@ -0,0 +1,421 @@
+#pragma once
+// Jakub Staroń, 2016-2017
+
+#include "headers.h"
+#include "numeric/montgomery_field.h"
+#include "numeric/prime_field.h"
+
+#ifdef HAVE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace pcl {
+namespace numeric {
+
+namespace detail {
+
+/**
+ * Instruction sets used by kernels operating on prime_field arrays.
+ */
+enum class simd_level {
+  kScalar,
+  kSse4,
+  kAvx2,
+};
+
+/**
+ * Returns best instruction set supported by compiler flags or,
+ * if compiled without them, by processor at runtime.
+ */
+inline simd_level detect_simd_level() {
+#if defined(__AVX2__)
+  return simd_level::kAvx2;
+#elif defined(HAVE_X86_SIMD)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    return simd_level::kAvx2;
+#if defined(__SSE4_1__)
+  return simd_level::kSse4;
+#else
+  if (__builtin_cpu_supports("sse4.1"))
+    return simd_level::kSse4;
+  return simd_level::kScalar;
+#endif
+#else
+  return simd_level::kScalar;
+#endif
+}
+
+/**
+ * Returns instruction set used by prime_field array kernels.
+ * Detected once, may be lowered (eg for testing), but never
+ * above detect_simd_level().
+ */
+inline simd_level& field_simd_level() {
+  static simd_level level = detect_simd_level();
+  return level;
+}
+
+enum class field_operation {
+  kAdd,         /// result = a + b
+  kSubtract,    /// result = a - b
+  kMultiply,    /// result = a * b
+  kMultiplyAdd, /// result += a * b
+  kScaleAdd,    /// result += scalar * a
+};
+
+/**
+ * Constants of Montgomery multiplication modulo odd prime.
+ * Kernels compute x * y / 2^32 (mod prime), values stay in normal
+ * form and are corrected by multiplying by square (or by passing
+ * scalar already multiplied by 2^32).
+ */
+struct field_constants {
+  uint32 prime;
+  uint32 inverse; /// prime^-1 (mod 2^32)
+  uint32 square;  /// 2^64 (mod prime)
+};
+
+template <uint32 prime>
+constexpr field_constants make_field_constants() {
+  return {prime, montgomery_inverse32(prime, prime, 4), uint32(((~uint64(0)) % prime + 1) % prime)};
+}
+
+#ifdef HAVE_X86_SIMD
+
+// Modular arithmetic on vectors of unsigned values smaller than prime.
+// Works for every prime below 2^32, so sums are never formed directly:
+// a + b is computed as a - (prime - b).
+
+__attribute__((target("avx2")))
+inline __m256i avx2_subtract(__m256i a, __m256i b, __m256i prime) {
+  const __m256i no_borrow = _mm256_cmpeq_epi32(_mm256_max_epu32(a, b), a);
+  return _mm256_add_epi32(_mm256_sub_epi32(a, b), _mm256_andnot_si256(no_borrow, prime));
+}
+
+__attribute__((target("avx2")))
+inline __m256i avx2_add(__m256i a, __m256i b, __m256i prime) {
+  return avx2_subtract(a, _mm256_sub_epi32(prime, b), prime);
+}
+
+__attribute__((target("avx2")))
+inline __m256i avx2_montgomery_multiply(__m256i a, __m256i b, __m256i prime, __m256i inverse) {
+  const __m256i even = _mm256_mul_epu32(a, b);
+  const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+  const __m256i even_correction = _mm256_mul_epu32(_mm256_mul_epu32(even, inverse), prime);
+  const __m256i odd_correction = _mm256_mul_epu32(_mm256_mul_epu32(odd, inverse), prime);
+  const __m256i high = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+  const __m256i correction = _mm256_blend_epi32(_mm256_srli_epi64(even_correction, 32), odd_correction, 0xAA);
+  return avx2_subtract(high, correction, prime);
+}
+
+/**
+ * Applies operation to whole vectors of 8 values, returns number of processed values.
+ */
+template <field_operation operation>
+__attribute__((target("avx2")))
+size_t avx2_field_kernel(const uint32* a, const uint32* b, uint32 scalar, uint32* result,
+                         size_t count, const field_constants& constants) {
+  const __m256i prime = _mm256_set1_epi32(constants.prime);
+  const __m256i inverse = _mm256_set1_epi32(constants.inverse);
+  const __m256i square = _mm256_set1_epi32(constants.square);
+  const __m256i multiplier = _mm256_set1_epi32(scalar);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    __m256i value;
+    if (operation == field_operation::kScaleAdd) {
+      value = avx2_montgomery_multiply(x, multiplier, prime, inverse);
+    }
+    else {
+      const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+      if (operation == field_operation::kAdd)
+        value = avx2_add(x, y, prime);
+      else if (operation == field_operation::kSubtract)
+        value = avx2_subtract(x, y, prime);
+      else
+        value = avx2_montgomery_multiply(avx2_montgomery_multiply(x, y, prime, inverse), square, prime, inverse);
+    }
+    if (operation == field_operation::kMultiplyAdd || operation == field_operation::kScaleAdd)
+      value = avx2_add(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(result + i)), value, prime);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(result + i), value);
+  }
+  return i;
+}
+
+/**
+ * Adds x * y / 2^32 (mod prime) over whole vectors of 8 values to sum,
+ * returns number of processed values.
+ */
+__attribute__((target("avx2")))
+inline size_t avx2_field_dot(const uint32* a, const uint32* b, size_t count,
+                             const field_constants& constants, uint64& sum) {
+  const __m256i prime = _mm256_set1_epi32(constants.prime);
+  const __m256i inverse = _mm256_set1_epi32(constants.inverse);
+  const __m256i low = _mm256_set1_epi64x(0xFFFFFFFF);
+  __m256i accumulator = _mm256_setzero_si256();
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+    const __m256i value = avx2_montgomery_multiply(x, y, prime, inverse);
+    accumulator = _mm256_add_epi64(accumulator, _mm256_and_si256(value, low));
+    accumulator = _mm256_add_epi64(accumulator, _mm256_srli_epi64(value, 32));
+  }
+  uint64 lanes[4];
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), accumulator);
+  sum += lanes[0] + lanes[1] + lanes[2] + lanes[3];
+  return i;
+}
+
+__attribute__((target("sse4.1")))
+inline __m128i sse4_subtract(__m128i a, __m128i b, __m128i prime) {
+  const __m128i no_borrow = _mm_cmpeq_epi32(_mm_max_epu32(a, b), a);
+  return _mm_add_epi32(_mm_sub_epi32(a, b), _mm_andnot_si128(no_borrow, prime));
+}
+
+__attribute__((target("sse4.1")))
+inline __m128i sse4_add(__m128i a, __m128i b, __m128i prime) {
+  return sse4_subtract(a, _mm_sub_epi32(prime, b), prime);
+}
+
+__attribute__((target("sse4.1")))
+inline __m128i sse4_montgomery_multiply(__m128i a, __m128i b, __m128i prime, __m128i inverse) {
+  const __m128i even = _mm_mul_epu32(a, b);
+  const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+  const __m128i even_correction = _mm_mul_epu32(_mm_mul_epu32(even, inverse), prime);
+  const __m128i odd_correction = _mm_mul_epu32(_mm_mul_epu32(odd, inverse), prime);
+  const __m128i high = _mm_blend_epi16(_mm_srli_epi64(even, 32), odd, 0xCC);
+  const __m128i correction = _mm_blend_epi16(_mm_srli_epi64(even_correction, 32), odd_correction, 0xCC);
+  return sse4_subtract(high, correction, prime);
+}
+
+/**
+ * Applies operation to whole vectors of 4 values, returns number of processed values.
+ */
+template <field_operation operation>
+__attribute__((target("sse4.1")))
+size_t sse4_field_kernel(const uint32* a, const uint32* b, uint32 scalar, uint32* result,
+                         size_t count, const field_constants& constants) {
+  const __m128i prime = _mm_set1_epi32(constants.prime);
+  const __m128i inverse = _mm_set1_epi32(constants.inverse);
+  const __m128i square = _mm_set1_epi32(constants.square);
+  const __m128i multiplier = _mm_set1_epi32(scalar);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    __m128i value;
+    if (operation == field_operation::kScaleAdd) {
+      value = sse4_montgomery_multiply(x, multiplier, prime, inverse);
+    }
+    else {
+      const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+      if (operation == field_operation::kAdd)
+        value = sse4_add(x, y, prime);
+      else if (operation == field_operation::kSubtract)
+        value = sse4_subtract(x, y, prime);
+      else
+        value = sse4_montgomery_multiply(sse4_montgomery_multiply(x, y, prime, inverse), square, prime, inverse);
+    }
+    if (operation == field_operation::kMultiplyAdd || operation == field_operation::kScaleAdd)
+      value = sse4_add(_mm_loadu_si128(reinterpret_cast<const __m128i*>(result + i)), value, prime);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(result + i), value);
+  }
+  return i;
+}
+
+/**
+ * Adds x * y / 2^32 (mod prime) over whole vectors of 4 values to sum,
+ * returns number of processed values.
+ */
+__attribute__((target("sse4.1")))
+inline size_t sse4_field_dot(const uint32* a, const uint32* b, size_t count,
+                             const field_constants& constants, uint64& sum) {
+  const __m128i prime = _mm_set1_epi32(constants.prime);
+  const __m128i inverse = _mm_set1_epi32(constants.inverse);
+  const __m128i low = _mm_set1_epi64x(0xFFFFFFFF);
+  __m128i accumulator = _mm_setzero_si128();
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+    const __m128i value = sse4_montgomery_multiply(x, y, prime, inverse);
+    accumulator = _mm_add_epi64(accumulator, _mm_and_si128(value, low));
+    accumulator = _mm_add_epi64(accumulator, _mm_srli_epi64(value, 32));
+  }
+  uint64 lanes[2];
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), accumulator);
+  sum += lanes[0] + lanes[1];
+  return i;
+}
+
+#endif // HAVE_X86_SIMD
+
+/**
+ * Runs vectorized kernel of operation for current simd_level,
+ * returns number of processed values (0 if none is available).
+ */
+template <field_operation operation>
+size_t field_kernel(const uint32* a, const uint32* b, uint32 scalar, uint32* result,
+                    size_t count, const field_constants& constants) {
+  if (constants.prime % 2 == 0)
+    return 0;
+#ifdef HAVE_X86_SIMD
+  switch (field_simd_level()) {
+    case simd_level::kAvx2:
+      return avx2_field_kernel<operation>(a, b, scalar, result, count, constants);
+    case simd_level::kSse4:
+      return sse4_field_kernel<operation>(a, b, scalar, result, count, constants);
+    default:
+      break;
+  }
+#endif
+  return 0;
+}
+
+/**
+ * Dot product counterpart of field_kernel.
+ */
+inline size_t field_dot_kernel(const uint32* a, const uint32* b, size_t count,
+                               const field_constants& constants, uint64& sum) {
+  if (constants.prime % 2 == 0)
+    return 0;
+#ifdef HAVE_X86_SIMD
+  switch (field_simd_level()) {
+    case simd_level::kAvx2:
+      return avx2_field_dot(a, b, count, constants, sum);
+    case simd_level::kSse4:
+      return sse4_field_dot(a, b, count, constants, sum);
+    default:
+      break;
+  }
+#endif
+  return 0;
+}
+
+template <uint32 prime>
+const uint32* field_values(const prime_field<prime>* values) {
+  static_assert(sizeof(prime_field<prime>) == sizeof(uint32) && std::is_standard_layout<prime_field<prime>>::value,
+                "field_values - prime_field must be layout compatible with uint32");
+  return reinterpret_cast<const uint32*>(values);
+}
+
+template <uint32 prime>
+uint32* field_values(prime_field<prime>* values) {
+  return const_cast<uint32*>(field_values(const_cast<const prime_field<prime>*>(values)));
+}
+
+/**
+ * Applies operation to arrays, vectorized part first and remaining values one by one.
+ */
+template <field_operation operation, uint32 prime>
+void field_map(const prime_field<prime>* a, const prime_field<prime>* b, prime_field<prime> scalar,
+               prime_field<prime>* result, size_t count) {
+  constexpr field_constants constants = make_field_constants<prime>();
+  const uint32 multiplier = uint32((uint64(scalar.value()) << 32) % prime);
+  size_t i = field_kernel<operation>(field_values(a), field_values(b), multiplier,
+                                     field_values(result), count, constants);
+  for (; i < count; i++) {
+    if (operation == field_operation::kAdd)
+      result[i] = a[i] + b[i];
+    else if (operation == field_operation::kSubtract)
+      result[i] = a[i] - b[i];
+    else if (operation == field_operation::kMultiply)
+      result[i] = a[i] * b[i];
+    else if (operation == field_operation::kMultiplyAdd)
+      result[i] += a[i] * b[i];
+    else
+      result[i] += scalar * a[i];
+  }
+}
+
+constexpr size_t kFieldDotChunk = size_t(1) << 30; /// keeps 64-bit sums of kernels from overflowing
+
+} // namespace detail
+
+/**
+ * Sets result[i] = a[i] + b[i] for i < count.
+ *
+ * Uses AVX2 or SSE4.1 when processor supports them (checked
+ * at runtime unless enabled by compiler flags), scalar code otherwise.
+ * Result may be the same array as a or b.
+ *
+ * Example:
+ * <pre>
+ * std::vector<prime_field<kNttPrime1>> a(n), b(n);
+ * FieldAdd(a.data(), b.data(), a.data(), n); // a += b
+ * </pre>
+ */
+template <uint32 prime>
+void FieldAdd(const prime_field<prime>* a, const prime_field<prime>* b, prime_field<prime>* result, size_t count) {
+  detail::field_map<detail::field_operation::kAdd>(a, b, prime_field<prime>(), result, count);
+}
+
+/**
+ * Sets result[i] = a[i] - b[i] for i < count.
+ */
+template <uint32 prime>
+void FieldSubtract(const prime_field<prime>* a, const prime_field<prime>* b, prime_field<prime>* result,
+                   size_t count) {
+  detail::field_map<detail::field_operation::kSubtract>(a, b, prime_field<prime>(), result, count);
+}
+
+/**
+ * Sets result[i] = a[i] * b[i] for i < count.
+ *
+ * Vectorized for odd primes with Montgomery multiplication, values
+ * stay in normal form.
+ */
+template <uint32 prime>
+void FieldMultiply(const prime_field<prime>* a, const prime_field<prime>* b, prime_field<prime>* result,
+                   size_t count) {
+  detail::field_map<detail::field_operation::kMultiply>(a, b, prime_field<prime>(), result, count);
+}
+
+/**
+ * Sets result[i] += a[i] * b[i] for i < count.
+ */
+template <uint32 prime>
+void FieldMultiplyAdd(const prime_field<prime>* a, const prime_field<prime>* b, prime_field<prime>* result,
+                      size_t count) {
+  detail::field_map<detail::field_operation::kMultiplyAdd>(a, b, prime_field<prime>(), result, count);
+}
+
+/**
+ * Sets result[i] += scalar * a[i] for i < count (axpy).
+ * Costs one Montgomery multiplication per value.
+ */
+template <uint32 prime>
+void FieldScaleAdd(const prime_field<prime>* a, prime_field<prime> scalar, prime_field<prime>* result,
+                   size_t count) {
+  detail::field_map<detail::field_operation::kScaleAdd>(a, a, scalar, result, count);
+}
+
+/**
+ * Returns sum of a[i] * b[i] for i < count.
+ *
+ * Vectorized part accumulates products in 64-bit lanes
+ * and reduces them once per chunk.
+ */
+template <uint32 prime>
+prime_field<prime> FieldDotProduct(const prime_field<prime>* a, const prime_field<prime>* b, size_t count) {
+  using field = prime_field<prime>;
+  constexpr detail::field_constants constants = detail::make_field_constants<prime>();
+  field result = 0;
+  size_t i = 0;
+  while (i < count) {
+    const size_t chunk = std::min(count - i, detail::kFieldDotChunk);
+    uint64 sum = 0;
+    const size_t done = detail::field_dot_kernel(detail::field_values(a + i), detail::field_values(b + i), chunk,
+                                                 constants, sum);
+    // Kernels sum a * b / 2^32, so sum is multiplied back by 2^32.
+    result += field(sum) * field(uint64(1) << 32);
+    for (size_t j = i + done; j < i + chunk; j++)
+      result += a[j] * b[j];
+    i += chunk;
+  }
+  return result;
+}
+
+} // namespace numeric
+} // namespace pcl
@@ -0,0 +1,365 @@
+#pragma once
+// Jakub Staroń, 2016-2017
+
+#include "headers.h"
+#include "numeric.h"
+#include "numeric/field_arrays.h"
+#include "numeric/prime_field.h"
+
+namespace pcl {
+namespace numeric {
+
+namespace detail {
+
+constexpr size_t kMatrixBlockColumns = 256;
+constexpr size_t kMatrixBlockInner = 128;
+
+/**
+ * Adds product of a (rows x inner) and b (inner x columns) to c (rows x columns).
+ *
+ * Loops are tiled, so that block of kMatrixBlockInner rows and
+ * kMatrixBlockColumns columns of b stays in cache while all rows of a pass.
+ */
+template <typename Value>
+void matrix_multiply(const Value* a, const Value* b, Value* c, size_t rows, size_t inner, size_t columns) {
+  for (size_t jj = 0; jj < columns; jj += kMatrixBlockColumns) {
+    const size_t width = std::min(kMatrixBlockColumns, columns - jj);
+    for (size_t kk = 0; kk < inner; kk += kMatrixBlockInner) {
+      const size_t depth = std::min(kMatrixBlockInner, inner - kk);
+      for (size_t i = 0; i < rows; i++) {
+        Value* target = c + i * columns + jj;
+        for (size_t k = kk; k < kk + depth; k++) {
+          const Value factor = a[i * inner + k];
+          const Value* source = b + k * columns + jj;
+          for (size_t j = 0; j < width; j++)
+            target[j] += factor * source[j];
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Specialization of matrix_multiply for prime_field with delayed reduction:
+ * products are accumulated in uint64 and reduced once per as many terms
+ * as fit without overflow (18 for primes around 10^9).
+ */
+template <uint32 prime>
+void matrix_multiply(const prime_field<prime>* a, const prime_field<prime>* b, prime_field<prime>* c,
+                     size_t rows, size_t inner, size_t columns) {
+  constexpr uint64 kMaximumProduct = uint64(prime - 1) * (prime - 1);
+  constexpr uint64 kFit = (kMaximumProduct == 0)? kMatrixBlockInner : (~uint64(0) - prime) / kMaximumProduct;
+  constexpr size_t kTerms = (kFit < kMatrixBlockInner)? size_t(kFit) : kMatrixBlockInner;
+  const uint32* x = field_values(a);
+  const uint32* y = field_values(b);
+  uint32* z = field_values(c);
+  uint64 accumulator[kMatrixBlockColumns];
+  for (size_t jj = 0; jj < columns; jj += kMatrixBlockColumns) {
+    const size_t width = std::min(kMatrixBlockColumns, columns - jj);
+    for (size_t kk = 0; kk < inner; kk += kMatrixBlockInner) {
+      const size_t depth = std::min(kMatrixBlockInner, inner - kk);
+      for (size_t i = 0; i < rows; i++) {
+        uint32* target = z + i * columns + jj;
+        std::copy(target, target + width, accumulator);
+        for (size_t k = kk; k < kk + depth; ) {
+          const size_t end = std::min(k + kTerms, kk + depth);
+          for (; k < end; k++) {
+            const uint64 factor = x[i * inner + k];
+            const uint32* source = y + k * columns + jj;
+            for (size_t j = 0; j < width; j++)
+              accumulator[j] += factor * source[j];
+          }
+          for (size_t j = 0; j < width; j++)
+            accumulator[j] %= prime;
+        }
+        std::copy(accumulator, accumulator + width, target);
+      }
+    }
+  }
+}
+
+/**
+ * Returns sum of a[i] * b[i] for i < count.
+ */
+template <typename Value>
+Value dot_product(const Value* a, const Value* b, size_t count) {
+  Value result = 0;
+  for (size_t i = 0; i < count; i++)
+    result += a[i] * b[i];
+  return result;
+}
+
+template <uint32 prime>
+prime_field<prime> dot_product(const prime_field<prime>* a, const prime_field<prime>* b, size_t count) {
+  return FieldDotProduct(a, b, count);
+}
+
+/**
+ * Sets target[i] += scalar * source[i] for i < count.
+ */
+template <typename Value>
+void scale_add(const Value* source, Value scalar, Value* target, size_t count) {
+  for (size_t i = 0; i < count; i++)
+    target[i] += scalar * source[i];
+}
+
+template <uint32 prime>
+void scale_add(const prime_field<prime>* source, prime_field<prime> scalar, prime_field<prime>* target,
+               size_t count) {
+  FieldScaleAdd(source, scalar, target, count);
+}
+
+} // namespace detail
+
+/**
+ * Dense matrix with values stored row by row.
+ *
+ * Designed for values forming a field (prime_field, dynamic_field,
+ * montgomery_field), for which multiplication, elimination,
+ * rank and determinant are available. For prime_field multiplication
+ * uses delayed reduction and row operations use vectorized kernels
+ * from field_arrays.h.
+ *
+ * Example:
+ * <pre>
+ * using field = prime_field<1000000007>;
+ * Matrix<field> fibonacci = {{1, 1}, {1, 0}};
+ * field f = power(fibonacci, 1000000)(0, 1); // millionth Fibonacci number
+ * </pre>
+ */
+template <typename Value>
+class Matrix {
+public:
+  using value_type = Value;
+  using size_type = uint32;
+
+  /**
+   * Constructs rows x columns matrix filled with value.
+   */
+  Matrix(size_type rows, size_type columns, const Value& value = Value(0)):
+      rows_(rows), columns_(columns), values_(size_t(rows) * columns, value) { }
+
+  /**
+   * Constructs matrix from list of rows, which must have equal lengths.
+   */
+  Matrix(std::initializer_list<std::initializer_list<Value>> rows):
+      rows_(uint32(rows.size())), columns_(rows.size() == 0? 0 : uint32(rows.begin()->size())) {
+    values_.reserve(size_t(rows_) * columns_);
+    for (const auto& row: rows) {
+      if (row.size() != columns_)
+        throw std::invalid_argument("Matrix - rows must have equal lengths");
+      values_.insert(values_.end(), row.begin(), row.end());
+    }
+  }
+
+  /**
+   * Returns n x n identity matrix.
+   */
+  static Matrix identity(size_type n) {
+    Matrix result(n, n);
+    for (size_type i = 0; i < n; i++)
+      result(i, i) = 1;
+    return result;
+  }
+
+  size_type rows() const {
+    return rows_;
+  }
+
+  size_type columns() const {
+    return columns_;
+  }
+
+  Value& operator()(size_type row, size_type column) {
+    return values_[size_t(row) * columns_ + column];
+  }
+
+  const Value& operator()(size_type row, size_type column) const {
+    return values_[size_t(row) * columns_ + column];
+  }
+
+  /**
+   * Returns pointer to first value of row, values of row are contiguous.
+   */
+  Value* row(size_type row) {
+    return values_.data() + size_t(row) * columns_;
+  }
+
+  const Value* row(size_type row) const {
+    return values_.data() + size_t(row) * columns_;
+  }
+
+  /**
+   * Throws std::invalid_argument if dimensions of matrices don't match.
+   */
+  friend Matrix operator+(const Matrix& lhs, const Matrix& rhs) {
+    lhs.checkSameDimensions(rhs);
+    Matrix result = lhs;
+    for (size_t i = 0; i < result.values_.size(); i++)
+      result.values_[i] += rhs.values_[i];
+    return result;
+  }
+
+  friend Matrix operator-(const Matrix& lhs, const Matrix& rhs) {
+    lhs.checkSameDimensions(rhs);
+    Matrix result = lhs;
+    for (size_t i = 0; i < result.values_.size(); i++)
+      result.values_[i] -= rhs.values_[i];
+    return result;
+  }
+
+  /**
+   * Returns product of matrices, complexity is O(rows * inner * columns).
+   *
+   * Throws std::invalid_argument if lhs.columns() != rhs.rows().
+   */
+  friend Matrix operator*(const Matrix& lhs, const Matrix& rhs) {
+    if (lhs.columns_ != rhs.rows_)
+      throw std::invalid_argument("Matrix - dimensions mismatch");
+    Matrix result(lhs.rows_, rhs.columns_);
+    detail::matrix_multiply(lhs.values_.data(), rhs.values_.data(), result.values_.data(),
+                            lhs.rows_, lhs.columns_, rhs.columns_);
+    return result;
+  }
+
+  /**
+   * Returns product of matrix and column vector.
+   *
+   * Throws std::invalid_argument if lhs.columns() != rhs.size().
+   */
+  friend std::vector<Value> operator*(const Matrix& lhs, const std::vector<Value>& rhs) {
+    if (lhs.columns_ != rhs.size())
+      throw std::invalid_argument("Matrix - dimensions mismatch");
+    std::vector<Value> result(lhs.rows_);
+    for (size_type i = 0; i < lhs.rows_; i++)
+      result[i] = detail::dot_product(lhs.row(i), rhs.data(), lhs.columns_);
+    return result;
+  }
+
+  void operator+=(const Matrix& rhs) {
+    *this = *this + rhs;
+  }
+
+  void operator-=(const Matrix& rhs) {
+    *this = *this - rhs;
+  }
+
+  void operator*=(const Matrix& rhs) {
+    *this = *this * rhs;
+  }
+
+  friend bool operator==(const Matrix& lhs, const Matrix& rhs) {
+    return lhs.rows_ == rhs.rows_ && lhs.columns_ == rhs.columns_ && lhs.values_ == rhs.values_;
+  }
+
+  friend bool operator!=(const Matrix& lhs, const Matrix& rhs) {
+    return !(lhs == rhs);
+  }
+
+private:
+  void checkSameDimensions(const Matrix& other) const {
+    if (rows_ != other.rows_ || columns_ != other.columns_)
+      throw std::invalid_argument("Matrix - dimensions mismatch");
+  }
+
+  size_type rows_;
+  size_type columns_;
+  std::vector<Value> values_;
+};
+
+/**
+ * Returns a^n, using pcl::power with identity matrix as one.
+ *
+ * Throws std::invalid_argument if a is not square.
+ */
+template <typename Value>
+Matrix<Value> power(const Matrix<Value>& a, uint64 n) {
+  if (a.rows() != a.columns())
+    throw std::invalid_argument("Matrix - power of non-square matrix");
+  return pcl::power(a, n, Matrix<Value>::identity(a.rows()));
+}
+
+namespace detail {
+
+/**
+ * Brings matrix to row echelon form with ones on pivots, returns its rank.
+ * If reduced is true, values above pivots are eliminated too.
+ * Sets determinant to determinant of original matrix, if it is square.
+ */
+template <typename Value>
+uint32 eliminate(Matrix<Value>& matrix, bool reduced, Value& determinant) {
+  const uint32 rows = matrix.rows(), columns = matrix.columns();
+  determinant = 1;
+  uint32 rank = 0;
+  for (uint32 column = 0; column < columns && rank < rows; column++) {
+    uint32 pivot = rank;
+    while (pivot < rows && matrix(pivot, column) == 0)
+      pivot++;
+    if (pivot == rows)
+      continue;
+    if (pivot != rank) {
+      std::swap_ranges(matrix.row(pivot) + column, matrix.row(pivot) + columns, matrix.row(rank) + column);
+      determinant = 0 - determinant;
+    }
+
+    Value* pivot_row = matrix.row(rank);
+    determinant *= pivot_row[column];
+    const Value scale = Value(1) / pivot_row[column];
+    for (uint32 j = column; j < columns; j++)
+      pivot_row[j] *= scale;
+
+    for (uint32 i = reduced? 0 : rank + 1; i < rows; i++) {
+      const Value factor = matrix(i, column);
+      if (i != rank && factor != 0)
+        scale_add(pivot_row + column, 0 - factor, matrix.row(i) + column, columns - column);
+    }
+    rank++;
+  }
+  if (rank < rows)
+    determinant = 0;
+  return rank;
+}
+
+} // namespace detail
+
+/**
+ * Transforms matrix to reduced row echelon form in place, returns its rank.
+ * Complexity is O(rows * columns * min(rows, columns)).
+ *
+ * Example:
+ * <pre>
+ * Matrix<prime_field<7>> m = {{1, 2, 3}, {2, 4, 1}};
+ * GaussianElimination(m); // m = {{1, 2, 0}, {0, 0, 1}}, returns 2
+ * </pre>
+ */
+template <typename Value>
+uint32 GaussianElimination(Matrix<Value>& matrix) {
+  Value determinant;
+  return detail::eliminate(matrix, true, determinant);
+}
+
+/**
+ * Returns rank of matrix.
+ */
+template <typename Value>
+uint32 Rank(Matrix<Value> matrix) {
+  Value determinant;
+  return detail::eliminate(matrix, false, determinant);
+}
+
+/**
+ * Returns determinant of square matrix.
+ *
+ * Throws std::invalid_argument if matrix is not square.
+ */
+template <typename Value>
+Value Determinant(Matrix<Value> matrix) {
+  if (matrix.rows() != matrix.columns())
+    throw std::invalid_argument("Determinant - matrix must be square");
+  Value determinant;
+  detail::eliminate(matrix, false, determinant);
+  return determinant;
+}
+
+} // namespace numeric
+} // namespace pcl
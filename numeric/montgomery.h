@@ -0,0 +1,185 @@
+#pragma once
+// Jakub Staroń, 2016-2017
+
+#include "headers.h"
+
+namespace pcl {
+namespace numeric {
+
+namespace detail {
+
+/**
+ * Returns high 64 bits of 128-bit product a * b.
+ *
+ * Uses compiler's 128-bit type whenever it is available, even without
+ * USE_INT128_TYPES: unlike 128-bit division it is a single instruction.
+ */
+inline uint64 multiply_high(uint64 a, uint64 b) {
+#ifdef HAVE_INT128_TYPES
+  return uint64((static_cast<unsigned __int128>(a) * b) >> 64);
+#else
+  const uint64 a_low = uint32(a), a_high = a >> 32;
+  const uint64 b_low = uint32(b), b_high = b >> 32;
+  const uint64 low_low = a_low * b_low;
+  const uint64 low_high = a_low * b_high;
+  const uint64 high_low = a_high * b_low;
+  const uint64 middle = (low_low >> 32) + uint32(low_high) + uint32(high_low);
+  return a_high * b_high + (low_high >> 32) + (high_low >> 32) + (middle >> 32);
+#endif
+}
+
+/**
+ * Returns inverse of a modulo n, for any n > 0.
+ *
+ * Uses extended Euclid algorithm on unsigned numbers: signs of
+ * coefficients alternate, so only their absolute values are kept.
+ * Throws std::runtime_error if a and n are not coprime.
+ */
+inline uint64 inverse_modulo(uint64 a, uint64 n) {
+  uint64 old_r = n, r = a % n;
+  uint64 old_t = 0, t = 1;
+  bool old_negative = false, negative = false;
+  while (r != 0) {
+    const uint64 q = old_r / r;
+    const uint64 next_r = old_r - q * r;
+    old_r = r;
+    r = next_r;
+    const uint64 next_t = old_t + q * t;
+    old_t = t;
+    t = next_t;
+    old_negative = negative;
+    negative = !negative;
+  }
+  if (old_r != 1)
+    throw std::runtime_error("inverse_modulo - number is not inversible");
+  return (old_negative && old_t != 0)? n - old_t : old_t % n;
+}
+
+} // namespace detail
+
+/**
+ * Montgomery form arithmetic modulo odd 64-bit number.
+ *
+ * Value a is represented as a * 2^64 (mod modulus), so modular
+ * multiplication needs no division. Works for every odd
+ * modulus smaller than 2^64, without 128-bit types.
+ * Values passed to and returned from arithmetic operations
+ * are in Montgomery form, use toMontgomery and fromMontgomery
+ * to convert them.
+ *
+ * Note that multiply(toMontgomery(a), b) for b not in
+ * Montgomery form gives plain a * b (mod modulus).
+ *
+ * Example:
+ * <pre>
+ * Montgomery64 context(1000000007);
+ * auto a = context.toMontgomery(123), b = context.toMontgomery(456);
+ * uint64 product = context.fromMontgomery(context.multiply(a, b)); // 56088
+ * uint64 x = context.fromMontgomery(context.power(a, 1000000005)); // 1/123
+ * </pre>
+ */
+class Montgomery64 {
+public:
+  /**
+   * Constructs context for given modulus.
+   *
+   * Throws std::invalid_argument if modulus is even.
+   */
+  explicit Montgomery64(uint64 modulus):
+      modulus_(modulus) {
+    if (modulus % 2 == 0)
+      throw std::invalid_argument("Montgomery64 - modulus must be odd");
+
+    inverse_ = modulus; // correct on 3 lowest bits
+    for (uint32 i = 0; i < 5; i++) // Newton iteration doubles number of correct bits
+      inverse_ *= 2 - modulus * inverse_;
+
+    one_ = (uint64(0) - modulus) % modulus;
+    square_ = one_;
+    for (uint32 i = 0; i < 64; i++)
+      square_ = add(square_, square_);
+  }
+
+  uint64 modulus() const {
+    return modulus_;
+  }
+
+  /**
+   * Returns 1 in Montgomery form.
+   */
+  uint64 one() const {
+    return one_;
+  }
+
+  /**
+   * Converts a to Montgomery form.
+   */
+  uint64 toMontgomery(uint64 a) const {
+    return multiply(a % modulus_, square_);
+  }
+
+  /**
+   * Converts a from Montgomery form.
+   */
+  uint64 fromMontgomery(uint64 a) const {
+    return reduce(0, a);
+  }
+
+  uint64 add(uint64 a, uint64 b) const {
+    const uint64 sum = a + b;
+    return (sum < a || sum >= modulus_)? sum - modulus_ : sum;
+  }
+
+  uint64 subtract(uint64 a, uint64 b) const {
+    return (a >= b)? a - b : a + (modulus_ - b);
+  }
+
+  uint64 multiply(uint64 a, uint64 b) const {
+    return reduce(detail::multiply_high(a, b), a * b);
+  }
+
+  /**
+   * Returns a^n, a and result are in Montgomery form.
+   */
+  uint64 power(uint64 a, uint64 n) const {
+    uint64 result = one_;
+    while (n > 0) {
+      if (n % 2 != 0)
+        result = multiply(result, a);
+      n /= 2;
+      a = multiply(a, a);
+    }
+    return result;
+  }
+
+  /**
+   * Returns 1/a, a and result are in Montgomery form.
+   *
+   * Modulus does not have to be prime. Throws std::runtime_error
+   * if a is not coprime with modulus.
+   */
+  uint64 inverse(uint64 a) const {
+    // (a * R)^-1 = a^-1 * R^-1, every multiplication by square_ adds factor R.
+    const uint64 inverse = detail::inverse_modulo(a, modulus_);
+    return multiply(multiply(inverse, square_), square_);
+  }
+
+private:
+  /**
+   * Returns (high * 2^64 + low) / 2^64 (mod modulus),
+   * for numbers smaller than modulus * 2^64.
+   */
+  uint64 reduce(uint64 high, uint64 low) const {
+    const uint64 m = low * inverse_;
+    const uint64 correction = detail::multiply_high(m, modulus_);
+    return (high >= correction)? high - correction : high + (modulus_ - correction);
+  }
+
+  uint64 modulus_;
+  uint64 inverse_; /// modulus^-1 (mod 2^64)
+  uint64 one_; /// 2^64 (mod modulus)
+  uint64 square_; /// 2^128 (mod modulus)
+};
+
+} // namespace numeric
+} // namespace pcl
@@ -0,0 +1,211 @@
+#pragma once
+// Jakub Staroń, 2016-2017
+
+#include "headers.h"
+#include "numeric/prime_field.h"
+
+namespace pcl {
+namespace numeric {
+
+// Predeclarations
+
+template <uint32 prime>
+class montgomery_field;
+
+/**
+ * Returns a^n in Z_prime.
+ */
+template<uint32 prime>
+montgomery_field<prime> power(montgomery_field<prime> a, uint64 n);
+
+/**
+ * Returns 1/lhs in Z_prime.
+ *
+ * Throws an std::runtime_error if lhs is not inversible (ie is 0).
+ */
+template<uint32 prime>
+montgomery_field<prime> inverse(const montgomery_field<prime>& lhs);
+
+template<uint32 prime>
+std::ostream& operator<<(std::ostream& stream, const montgomery_field<prime>& lhs);
+
+template<uint32 prime>
+std::istream& operator>>(std::istream& stream, montgomery_field<prime>& lhs);
+
+// Predeclarations End
+
+namespace detail {
+
+/**
+ * Returns prime^-1 (mod 2^32), for odd prime.
+ *
+ * Every Newton iteration doubles number of correct bits,
+ * initial value is correct on 3 lowest bits.
+ */
+constexpr uint32 montgomery_inverse32(uint32 prime, uint32 inverse, uint32 steps) {
+  return (steps == 0)? inverse : montgomery_inverse32(prime, inverse * (2 - prime * inverse), steps - 1);
+}
+
+/**
+ * Returns value / 2^32 (mod prime), for value smaller than prime * 2^32.
+ */
+constexpr uint32 montgomery_reduce32(uint64 value, uint32 prime, uint32 inverse) {
+  return subtract_modulo(uint32(value >> 32),
+                         uint32((uint64(uint32(value) * inverse) * prime) >> 32),
+                         prime);
+}
+
+} // namespace detail
+
+/**
+ * Integers modulo compiled-time odd prime, kept in Montgomery form.
+ *
+ * Drop-in replacement of prime_field: value a is stored as
+ * a * 2^32 (mod prime), so multiplication needs no division,
+ * only two 32x32-bit multiplications and a subtraction.
+ * Conversions from and to integers cost one multiplication each.
+ * Note that memory representation differs from prime_field.
+ *
+ * Example:
+ * <pre>
+ * using field = montgomery_field<uint32_prime1>;
+ * field a = 5, b = -1;
+ * uint32 x = (a * b).value(); // uint32_prime1 - 5
+ * </pre>
+ */
+template <uint32 prime>
+class montgomery_field {
+  static_assert(prime % 2 == 1, "montgomery_field - prime must be odd");
+
+public:
+  constexpr montgomery_field():
+      value_(0) { }
+
+  template <typename Integral, typename = typename std::enable_if<std::is_integral<Integral>::value>::type>
+  constexpr montgomery_field(Integral value):
+      value_(reduce(uint64(detail::modulo(value, prime)) * kSquare)) { }
+
+  friend constexpr montgomery_field operator+(const montgomery_field& lhs, const montgomery_field& rhs) {
+    return montgomery_field(detail::add_modulo(lhs.value_, rhs.value_, prime), detail::reduced_tag());
+  }
+
+  friend constexpr montgomery_field operator-(const montgomery_field& lhs, const montgomery_field& rhs) {
+    return montgomery_field(detail::subtract_modulo(lhs.value_, rhs.value_, prime), detail::reduced_tag());
+  }
+
+  friend constexpr montgomery_field operator*(const montgomery_field& lhs, const montgomery_field& rhs) {
+    return montgomery_field(reduce(uint64(lhs.value_) * rhs.value_), detail::reduced_tag());
+  }
+
+  friend montgomery_field power <>(montgomery_field a, uint64 n);
+  friend montgomery_field inverse <>(const montgomery_field& lhs);
+
+  /**
+   * Returns lhs/rhs in Z_prime.
+   */
+  friend montgomery_field operator/(const montgomery_field& lhs, const montgomery_field& rhs) {
+    return lhs * inverse(rhs);
+  }
+
+  void operator+=(const montgomery_field& rhs);
+  void operator-=(const montgomery_field& rhs);
+  void operator*=(const montgomery_field& rhs);
+  void operator/=(const montgomery_field& rhs);
+
+  friend constexpr bool operator==(const montgomery_field& lhs, const montgomery_field& rhs) {
+    return lhs.value_ == rhs.value_;
+  }
+
+  friend constexpr bool operator!=(const montgomery_field& lhs, const montgomery_field& rhs) {
+    return !(lhs == rhs);
+  }
+
+  /**
+   * Returns conversion of value to uint32.
+   */
+  constexpr uint32 value() const {
+    return reduce(value_);
+  }
+
+  friend std::ostream& operator<< <>(std::ostream& stream, const montgomery_field& lhs);
+  friend std::istream& operator>> <>(std::istream& stream, montgomery_field& lhs);
+
+private:
+  static constexpr uint32 kInverse = detail::montgomery_inverse32(prime, prime, 4); /// prime^-1 (mod 2^32)
+  static constexpr uint32 kSquare = ((~uint64(0)) % prime + 1) % prime; /// 2^64 (mod prime)
+
+  constexpr montgomery_field(uint32 value, detail::reduced_tag):
+      value_(value) { }
+
+  static constexpr uint32 reduce(uint64 value) {
+    return detail::montgomery_reduce32(value, prime, kInverse);
+  }
+
+  uint32 value_;
+};
+
+template<uint32 prime>
+constexpr uint32 montgomery_field<prime>::kInverse;
+
+template<uint32 prime>
+constexpr uint32 montgomery_field<prime>::kSquare;
+
+template<uint32 prime>
+montgomery_field<prime> power(montgomery_field<prime> a, uint64 n) {
+  if (n == 0)
+    return 1;
+  else if (a == 0)
+    return 0;
+  n %= (prime - 1); // Fermat little theorem
+  montgomery_field<prime> result = 1;
+  while (n > 0) {
+    if (n % 2 == 1)
+      result *= a;
+    a *= a;
+    n /= 2;
+  }
+  return result;
+}
+
+template<uint32 prime>
+montgomery_field<prime> inverse(const montgomery_field<prime>& lhs) {
+  if (lhs == 0)
+    throw std::runtime_error("montgomery_field - inverse of zero");
+  return power(lhs, prime - 2);
+}
+
+template<uint32 prime>
+void montgomery_field<prime>::operator+=(const montgomery_field<prime>& rhs) {
+  *this = *this + rhs;
+}
+
+template<uint32 prime>
+void montgomery_field<prime>::operator-=(const montgomery_field<prime>& rhs) {
+  *this = *this - rhs;
+}
+
+template<uint32 prime>
+void montgomery_field<prime>::operator*=(const montgomery_field<prime>& rhs) {
+  *this = *this * rhs;
+}
+
+template<uint32 prime>
+void montgomery_field<prime>::operator/=(const montgomery_field<prime>& rhs) {
+  *this = *this / rhs;
+}
+
+template<uint32 prime>
+std::ostream& operator<<(std::ostream& stream, const montgomery_field<prime>& lhs) {
+  return stream << lhs.value();
+}
+
+template<uint32 prime>
+std::istream& operator>>(std::istream& stream, montgomery_field<prime>& lhs) {
+  int64 value;
+  stream >> value;
+  lhs = montgomery_field<prime>(value);
+  return stream;
+}
+
+} // namespace numeric
+} // namespace pcl
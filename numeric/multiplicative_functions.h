@@ -0,0 +1,103 @@
+#pragma once
+// Jakub Staroń, 2016-2017
+
+#include "headers.h"
+
+namespace pcl {
+namespace numeric {
+
+/**
+ * Returns vector of values of multiplicative function f
+ * for k = 0, 1, ..., n - 1, with f(0) = 0 and f(1) = 1.
+ *
+ * Function is given by its values on prime powers: prime_power(p, k, q)
+ * must return f(q) for q = p^k. It is called once per prime power below n.
+ *
+ * Uses linear sieve, which visits every composite once through its
+ * smallest prime factor p, so f(i * p) is computed by one multiplication
+ * f(i * p / q) * f(q), where q is the biggest power of p dividing i * p.
+ * Complexity is O(n), memory is 5 bytes per number on top of result.
+ *
+ * Example:
+ * <pre>
+ * // number of distinct prime factors as power of two, ie 2^omega(k)
+ * auto values = MultiplicativeFunctionValues<uint32>(100, [](uint32, uint32, uint32) { return 2; });
+ * </pre>
+ */
+template <typename Value, typename PrimePowerFunction>
+std::vector<Value> MultiplicativeFunctionValues(uint32 n, PrimePowerFunction prime_power) {
+  std::vector<Value> values(n, Value(0));
+  if (n <= 1)
+    return values;
+  values[1] = Value(1);
+
+  std::vector<uint32> lowest(n, 0); // biggest power of smallest prime factor dividing k
+  std::vector<uint8> exponent(n, 0);
+  std::vector<uint32> primes;
+  for (uint32 i = 2; i < n; i++) {
+    if (lowest[i] == 0) {
+      lowest[i] = i;
+      exponent[i] = 1;
+      primes.push_back(i);
+      values[i] = prime_power(i, 1, i);
+    }
+    for (const uint32 p: primes) {
+      const uint64 j = uint64(p) * i;
+      if (j >= n)
+        break;
+      if (i % p == 0) {
+        lowest[j] = lowest[i] * p;
+        exponent[j] = exponent[i] + 1;
+        if (lowest[j] == j)
+          values[j] = prime_power(p, exponent[j], uint32(j));
+        else
+          values[j] = values[j / lowest[j]] * values[lowest[j]];
+        break;
+      }
+      lowest[j] = p;
+      exponent[j] = 1;
+      values[j] = values[i] * values[p];
+    }
+  }
+  return values;
+}
+
+/**
+ * Returns vector with values of Euler's totient function
+ * for k = 0, 1, ..., n - 1. Complexity is O(n).
+ */
+std::vector<uint32> TotientFunctionValues(uint32 n) {
+  return MultiplicativeFunctionValues<uint32>(n, [](uint32 p, uint32, uint32 q) {
+    return q - q / p;
+  });
+}
+
+/**
+ * Returns vector with values of Mobius function for k = 0, 1, ..., n - 1.
+ */
+std::vector<int8> MobiusFunctionValues(uint32 n) {
+  return MultiplicativeFunctionValues<int8>(n, [](uint32, uint32 k, uint32) {
+    return int8((k == 1)? -1 : 0);
+  });
+}
+
+/**
+ * Returns vector with numbers of divisors of k for k = 0, 1, ..., n - 1.
+ */
+std::vector<uint32> DivisorCountValues(uint32 n) {
+  return MultiplicativeFunctionValues<uint32>(n, [](uint32, uint32 k, uint32) {
+    return k + 1;
+  });
+}
+
+/**
+ * Returns vector with sums of divisors of k for k = 0, 1, ..., n - 1.
+ */
+std::vector<uint64> DivisorSumValues(uint32 n) {
+  return MultiplicativeFunctionValues<uint64>(n, [](uint32 p, uint32, uint32 q) {
+    return (uint64(q) * p - 1) / (p - 1);
+  });
+}
+
+} // namespace numeric
+} // namespace pcl
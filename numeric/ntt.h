@@ -0,0 +1,353 @@
+#pragma once
+// Jakub Staroń, 2016-2017
+
+#include "headers.h"
+#include "numeric.h"
+#include "numeric/number_theory.h"
+#include "numeric/prime_field.h"
+
+namespace pcl {
+namespace numeric {
+
+/**
+ * Primes of form c * 2^k + 1 with big k, suitable for NTT.
+ */
+constexpr uint32 kNttPrime1 = 998244353; /// 119 * 2^23 + 1
+constexpr uint32 kNttPrime2 = 167772161; /// 5 * 2^25 + 1
+constexpr uint32 kNttPrime3 = 469762049; /// 7 * 2^26 + 1
+
+namespace detail {
+
+constexpr size_t kNaiveConvolutionThreshold = 32;
+
+/**
+ * Tables of roots of unity modulo prime, shared by all transforms
+ * of current thread. Table for size n is computed once and contains
+ * w_2k^j at position k + j for every power of two k < n and j < k,
+ * where w_2k is primitive root of unity of degree 2k.
+ */
+template <uint32 prime>
+class ntt_tables {
+public:
+  using field = prime_field<prime>;
+
+  /**
+   * Returns largest size of transform modulo prime.
+   */
+  static size_t maxSize() {
+    return size_t(1) << least_significant_one(prime - 1);
+  }
+
+  /**
+   * Returns table of roots good for transforms of size up to n.
+   */
+  static const std::vector<field>& roots(size_t n) {
+    static thread_local std::vector<field> roots = {0, 1};
+    if (roots.size() < n) {
+      const field generator = primitiveRoot();
+      roots.reserve(n);
+      for (size_t k = roots.size(); k < n; k *= 2) {
+        const field w = power(generator, (prime - 1) / (2 * k));
+        for (size_t j = 0; j < k; j++)
+          roots.push_back((j % 2 == 0)? roots[(k + j) / 2] : roots.back() * w);
+      }
+    }
+    return roots;
+  }
+
+private:
+  static uint32 primitiveRoot() {
+    static const uint32 root = PrimitiveRootFinder(prime).find();
+    return root;
+  }
+};
+
+constexpr size_t kNttBlockSize = 1 << 12;
+
+/**
+ * Performs butterfly stages of decimation in time merging blocks
+ * of lengths from range [first_length, last_length) in values[0, n).
+ */
+template <uint32 prime>
+void ntt_time_stages(prime_field<prime>* values, size_t n, size_t first_length, size_t last_length,
+                     const prime_field<prime>* roots) {
+  using field = prime_field<prime>;
+  for (size_t length = first_length; length < last_length; length *= 2) {
+    for (size_t i = 0; i < n; i += 2 * length) {
+      field* left = values + i;
+      field* right = values + i + length;
+      const field* root = roots + length;
+      for (size_t j = 0; j < length; j++) {
+        const field v = right[j] * root[j];
+        right[j] = left[j] - v;
+        left[j] = left[j] + v;
+      }
+    }
+  }
+}
+
+/**
+ * Performs butterfly stages of decimation in frequency splitting blocks
+ * into halves of lengths from range (last_length, first_length] in values[0, n).
+ */
+template <uint32 prime>
+void ntt_frequency_stages(prime_field<prime>* values, size_t n, size_t first_length, size_t last_length,
+                          const prime_field<prime>* roots) {
+  using field = prime_field<prime>;
+  for (size_t length = first_length; length > last_length; length /= 2) {
+    for (size_t i = 0; i < n; i += 2 * length) {
+      field* left = values + i;
+      field* right = values + i + length;
+      const field* root = roots + length;
+      for (size_t j = 0; j < length; j++) {
+        const field u = left[j], v = right[j];
+        left[j] = u + v;
+        right[j] = (u - v) * root[j];
+      }
+    }
+  }
+}
+
+/**
+ * Transforms values given in bit-reversed order, result is in natural order.
+ *
+ * Stages merging blocks shorter than kNttBlockSize are done block
+ * after block, so that each block stays in cache.
+ */
+template <uint32 prime>
+void ntt_decimation_in_time(prime_field<prime>* values, size_t n, const prime_field<prime>* roots) {
+  const size_t block = std::min(n, kNttBlockSize);
+  for (size_t begin = 0; begin < n; begin += block)
+    ntt_time_stages(values + begin, block, 1, block, roots);
+  ntt_time_stages(values, n, block, n, roots);
+}
+
+/**
+ * Transforms values given in natural order, result is in bit-reversed order.
+ */
+template <uint32 prime>
+void ntt_decimation_in_frequency(prime_field<prime>* values, size_t n, const prime_field<prime>* roots) {
+  const size_t block = std::min(n, kNttBlockSize);
+  ntt_frequency_stages(values, n, n / 2, block / 2, roots);
+  for (size_t begin = 0; begin < n; begin += block)
+    ntt_frequency_stages(values + begin, block, block / 2, 0, roots);
+}
+
+template <uint32 prime>
+void ntt_bit_reverse(std::vector<prime_field<prime>>& values) {
+  const size_t n = values.size();
+  for (size_t i = 1, j = 0; i < n; i++) {
+    size_t bit = n >> 1;
+    for (; j & bit; bit >>= 1)
+      j ^= bit;
+    j ^= bit;
+    if (i < j)
+      std::swap(values[i], values[j]);
+  }
+}
+
+/**
+ * Multiplies polynomials with coefficients in Z_prime naively.
+ */
+template <uint32 prime>
+std::vector<prime_field<prime>> naive_convolution(const std::vector<prime_field<prime>>& a,
+                                                  const std::vector<prime_field<prime>>& b) {
+  std::vector<prime_field<prime>> result(a.size() + b.size() - 1);
+  for (size_t i = 0; i < a.size(); i++)
+    for (size_t j = 0; j < b.size(); j++)
+      result[i + j] += a[i] * b[j];
+  return result;
+}
+
+} // namespace detail
+
+/**
+ * Computes number-theoretic transform of values in place,
+ * ie values of polynomial in powers of root of unity of degree values.size().
+ * If inverse is true, computes inverse transform.
+ *
+ * Size of values must be power of two, not bigger than largest
+ * power of two dividing prime - 1. Otherwise std::invalid_argument is thrown.
+ * Roots of unity are computed once per thread and size.
+ *
+ * Example:
+ * <pre>
+ * std::vector<prime_field<kNttPrime1>> v = {1, 2, 3, 4};
+ * NumberTheoreticTransform(v);
+ * NumberTheoreticTransform(v, true); // v = {1, 2, 3, 4}
+ * </pre>
+ */
+template <uint32 prime>
+void NumberTheoreticTransform(std::vector<prime_field<prime>>& values, bool inverse = false) {
+  using field = prime_field<prime>;
+  const size_t n = values.size();
+  if (n == 0 || (n & (n - 1)) != 0)
+    throw std::invalid_argument("NumberTheoreticTransform - size must be power of two");
+  if (n > detail::ntt_tables<prime>::maxSize())
+    throw std::invalid_argument("NumberTheoreticTransform - size too big for prime");
+
+  const auto& roots = detail::ntt_tables<prime>::roots(n);
+  if (inverse)
+    std::reverse(values.begin() + 1, values.end());
+  detail::ntt_bit_reverse(values);
+
+  detail::ntt_decimation_in_time(values.data(), n, roots.data());
+
+  if (inverse) {
+    const field scale = numeric::inverse(field(n));
+    for (auto& value: values)
+      value *= scale;
+  }
+}
+
+/**
+ * Returns product of polynomials with coefficients in Z_prime,
+ * ie result[k] is sum of a[i] * b[j] over i + j = k.
+ *
+ * Uses NumberTheoreticTransform, so a.size() + b.size() - 1 must not be
+ * bigger than largest power of two dividing prime - 1.
+ * Complexity is O(n log n), for short polynomials naive algorithm is used.
+ */
+template <uint32 prime>
+std::vector<prime_field<prime>> Convolution(const std::vector<prime_field<prime>>& a,
+                                            const std::vector<prime_field<prime>>& b) {
+  using field = prime_field<prime>;
+  if (a.empty() || b.empty())
+    return {};
+  if (std::min(a.size(), b.size()) <= detail::kNaiveConvolutionThreshold)
+    return detail::naive_convolution(a, b);
+
+  const size_t size = a.size() + b.size() - 1;
+  size_t n = 1;
+  while (n < size)
+    n *= 2;
+
+  if (n > detail::ntt_tables<prime>::maxSize())
+    throw std::invalid_argument("Convolution - result too long for prime");
+
+  // Forward transforms leave values in bit-reversed order, which is exactly
+  // what decimation in time expects, so no bit reversal is needed.
+  const auto& roots = detail::ntt_tables<prime>::roots(n);
+  std::vector<field> fa(n), fb;
+  std::copy(a.begin(), a.end(), fa.begin());
+  detail::ntt_decimation_in_frequency(fa.data(), n, roots.data());
+  if (&a == &b) {
+    for (auto& value: fa)
+      value *= value;
+  }
+  else {
+    fb.resize(n);
+    std::copy(b.begin(), b.end(), fb.begin());
+    detail::ntt_decimation_in_frequency(fb.data(), n, roots.data());
+    for (size_t i = 0; i < n; i++)
+      fa[i] *= fb[i];
+  }
+  detail::ntt_decimation_in_time(fa.data(), n, roots.data());
+
+  // Forward transform applied twice gives n * value[-k].
+  const field scale = inverse(field(n));
+  std::vector<field> result(size);
+  for (size_t k = 0; k < size; k++)
+    result[k] = fa[(n - k) & (n - 1)] * scale;
+  return result;
+}
+
+namespace detail {
+
+template <uint32 prime>
+std::vector<prime_field<prime>> reduce_coefficients(const std::vector<uint64>& values) {
+  return std::vector<prime_field<prime>>(values.begin(), values.end());
+}
+
+/**
+ * Computes convolution of a and b modulo kNttPrime1, kNttPrime2 and
+ * kNttPrime3, then calls combine(i, x, y, k) for every coefficient.
+ * True value of coefficient is x + y * k, where x < p1 * p2 equals it
+ * modulo p1 * p2, y = p1 * p2 and k < p3.
+ */
+template <typename Combine>
+void three_prime_convolution(const std::vector<uint64>& a, const std::vector<uint64>& b, Combine combine) {
+  constexpr uint64 p1 = kNttPrime1, p2 = kNttPrime2, p3 = kNttPrime3;
+  // Garner's algorithm, p1 * p2 * p3 does not fit in uint64 so MergeCongruences can't be used.
+  static const uint64 inverse12 = inverse_modulo(p1, p2);
+  static const uint64 inverse123 = inverse_modulo(p1 * p2, p3);
+
+  const auto r1 = Convolution(reduce_coefficients<kNttPrime1>(a), reduce_coefficients<kNttPrime1>(b));
+  const auto r2 = Convolution(reduce_coefficients<kNttPrime2>(a), reduce_coefficients<kNttPrime2>(b));
+  const auto r3 = Convolution(reduce_coefficients<kNttPrime3>(a), reduce_coefficients<kNttPrime3>(b));
+
+  for (size_t i = 0; i < r1.size(); i++) {
+    const uint64 x1 = r1[i].value();
+    const uint64 k2 = (r2[i].value() + p2 - x1 % p2) * inverse12 % p2;
+    const uint64 x12 = x1 + p1 * k2;
+    const uint64 k3 = (r3[i].value() + p3 - x12 % p3) * inverse123 % p3;
+    combine(i, x12, p1 * p2, k3);
+  }
+}
+
+} // namespace detail
+
+/**
+ * Returns product of polynomials modulo given number, ie result[k]
+ * is sum of a[i] * b[j] over i + j = k, modulo modulo.
+ *
+ * Computes convolutions modulo three NTT primes and merges them
+ * by Chinese remainder theorem, which is exact as long as
+ * min(a.size(), b.size()) * (modulo - 1)^2 < kNttPrime1 * kNttPrime2 * kNttPrime3
+ * (about 7.8 * 10^25), eg for modulo up to 2^31 and 2^23 coefficients.
+ * Otherwise throws std::invalid_argument.
+ *
+ * Example:
+ * <pre>
+ * auto c = ConvolutionModulo({1, 2}, {3, 4}, 1000000007); // {3, 10, 8}
+ * </pre>
+ */
+std::vector<uint64> ConvolutionModulo(const std::vector<uint64>& a, const std::vector<uint64>& b, uint64 modulo) {
+  if (modulo == 0)
+    throw std::invalid_argument("ConvolutionModulo - modulo must be positive");
+  if (a.empty() || b.empty())
+    return {};
+  const long double bound = (long double)(kNttPrime1) * kNttPrime2 * kNttPrime3;
+  const long double maximum = (long double)(std::min(a.size(), b.size())) * (modulo - 1) * (modulo - 1);
+  if (maximum >= bound)
+    throw std::invalid_argument("ConvolutionModulo - modulo too big for exact result");
+
+  std::vector<uint64> ra(a.size()), rb(b.size());
+  for (size_t i = 0; i < a.size(); i++)
+    ra[i] = a[i] % modulo;
+  for (size_t i = 0; i < b.size(); i++)
+    rb[i] = b[i] % modulo;
+
+  std::vector<uint64> result(a.size() + b.size() - 1);
+  detail::three_prime_convolution(ra, rb, [&](size_t i, uint64 x, uint64 y, uint64 k) {
+    const uint64 yk = (modulo >> 32 == 0)? (y % modulo) * k % modulo : Multiply64(y % modulo, k, modulo);
+    result[i] = Add64(x % modulo, yk, modulo);
+  });
+  return result;
+}
+
+/**
+ * Returns product of polynomials with nonnegative integer coefficients.
+ *
+ * Result is exact if true coefficients of result are smaller than 2^64
+ * (eg. for coefficients smaller than 2^20 and 2^23 of them), otherwise
+ * coefficients modulo 2^64 are returned as long as they are smaller
+ * than kNttPrime1 * kNttPrime2 * kNttPrime3.
+ *
+ * Example:
+ * <pre>
+ * auto c = Convolution64({1000000, 2}, {3000000, 4}); // {3000000000000, 10000000, 8}
+ * </pre>
+ */
+std::vector<uint64> Convolution64(const std::vector<uint64>& a, const std::vector<uint64>& b) {
+  if (a.empty() || b.empty())
+    return {};
+  std::vector<uint64> result(a.size() + b.size() - 1);
+  detail::three_prime_convolution(a, b, [&](size_t i, uint64 x, uint64 y, uint64 k) {
+    result[i] = x + y * k;
+  });
+  return result;
+}
+
+} // namespace numeric
+} // namespace pcl
@@ -3,6 +3,11 @@
 
 #include "headers.h"
 #include "numeric.h"
+#include "numeric/big_unsigned.h"
+#include "numeric/sieve.h"
+#include "numeric/smallest_prime_factor.h"
+#include "numeric/montgomery.h"
+#include "numeric/dynamic_field.h"
 
 namespace pcl {
 namespace numeric {
@@ -19,15 +24,33 @@ uint64 Modulo(int64 value, uint64 modulo) {
 /**
  * Returns greatest common divisor of two numbers.
  *
+ * Uses Stein's binary algorithm: common power of two is taken out
+ * with least_significant_one, then smaller odd number is subtracted
+ * from bigger one, so no division is performed. Loop is branchless:
+ * trailing zeros of difference are counted while its absolute value
+ * and minimum are computed.
+ *
  * Note that arguments are unsigned.
  */
 uint64 GCD(uint64 a, uint64 b) {
+  if (a == 0)
+    return b;
+  if (b == 0)
+    return a;
+  uint32 a_zeros = least_significant_one(a);
+  const uint32 b_zeros = least_significant_one(b);
+  const uint32 shift = std::min(a_zeros, b_zeros);
+  b >>= b_zeros;
   while (a != 0) {
-    uint64 t = a;
-    a = b % a;
-    b = t;
+    a >>= a_zeros;
+    const uint64 difference = b - a;
+    const uint64 sign = 0 - uint64(b < a);
+    // Top bit keeps argument non-zero, result is unused when difference is 0.
+    a_zeros = least_significant_one(difference | (1uLL << 63));
+    b = std::min(a, b);
+    a = (difference ^ sign) - sign;
   }
-  return b;
+  return b << shift;
 }
 
 /**
@@ -36,58 +59,17 @@ uint64 GCD(uint64 a, uint64 b) {
  * Note that arguments are signed.
  */
 int64_pair ExtendedGCD(int64 a, int64 b) {
-  if(a == 0) {
-    return {0, 1};
-  }
-  else {
-    int64 x,y;
-    std::tie(x, y) = ExtendedGCD(b % a, a);
-    return {y - (b/a) * x, x};
-  }
-}
-
-/**
- * Merges two congruences using Chinese remainder theorem.
- * Congruence x = a (mod p) is denoted as pair (a, p).
- *
- * If those congruences are contradictary throws std::runtime_error.
- *
- * Suppose we have two congruences:
- * x = a (mod p)
- * x = b (mod q)
- * Where a, p, b, q are given.
- *
- * We want to merge those congruences, ie
- * find c, r such that congruence
- * x = c (mod r) is equivalent to two above
- */
-uint64_pair MergeCongruences(const uint64_pair first, const uint64_pair second) {
-  int64 a, b, p, q;
-  std::tie(a, p) = first;
-  std::tie(b, q) = second;
-
-  int64 gcd = GCD(p,q);
-  if((a - b) % gcd != 0)
-    throw std::runtime_error("MergeCongruences - contradiction!");
-
-  const int64 x = ExtendedGCD(p, q).first;
-
-  const int64 c = a + p * (b - a) / gcd * x;
-  const int64 m = p * q / gcd;
-
-  return {Modulo(c, m), m};
-}
-
-/**
- * Returns result of merging congruences from range [behin, end)
- */
-template <typename Iterator>
-uint64_pair MergeCongruences(Iterator begin, Iterator end) {
-  uint64_pair result{0, 1};
-  for (const auto& elem: make_range(begin, end)) {
-    result = MergeCongruences(result, elem);
+  // Invariants: a * old_x + b * old_y = old_r, a * x + b * y = r.
+  int64 old_r = b, r = a;
+  int64 old_x = 0, x = 1;
+  int64 old_y = 1, y = 0;
+  while (r != 0) {
+    const int64 q = old_r / r;
+    std::tie(old_r, r) = std::make_pair(r, old_r - q * r);
+    std::tie(old_x, x) = std::make_pair(x, old_x - q * x);
+    std::tie(old_y, y) = std::make_pair(y, old_y - q * y);
   }
-  return result;
+  return {old_x, old_y};
 }
 
 /**
@@ -156,35 +138,50 @@ uint64 Multiply64(uint64 a, uint64 b, uint64 modulo) {
 
 #else
 
+namespace detail {
+
+/**
+ * Returns (a + b) (mod modulo) for a, b < modulo.
+ */
+inline uint64 add_reduced(uint64 a, uint64 b, uint64 modulo) {
+  return (a >= modulo - b)? a - (modulo - b) : a + b;
+}
+
+} // namespace detail
+
 /**
  * Returns (a + b) (mod modulo)
- *
- * Note that a + b should be smaller than 2^64.
  */
 uint64 Add64(uint64 a, uint64 b, uint64 modulo) {
-  return (a + b) % modulo;
+  if (a >= modulo)
+    a %= modulo;
+  if (b >= modulo)
+    b %= modulo;
+  return detail::add_reduced(a, b, modulo);
 }
 
 /**
  * Returns (a - b) (mod modulo)
- *
- * Note that a + modulo should be smaller than 2^64.
  */
 uint64 Subtract64(uint64 a, uint64 b, uint64 modulo) {
-  return (modulo + a - b) % modulo;
+  if (a >= modulo)
+    a %= modulo;
+  if (b >= modulo)
+    b %= modulo;
+  return (a >= b)? a - b : a + (modulo - b);
 }
 
 /**
  * Returns (a * b) (mod modulo)
- *
- * Note that 2 * modulo should be smaller than 2^64.
  */
 uint64 Multiply64(uint64 a, uint64 b, uint64 modulo) {
+  if (a >= modulo)
+    a %= modulo;
   uint64 result = 0;
   while (b > 0) {
     if(b % 2 == 1)
-      result = Add64(result, a, modulo);
-    a = Add64(a, a, modulo);
+      result = detail::add_reduced(result, a, modulo);
+    a = detail::add_reduced(a, a, modulo);
     b /= 2;
   }
   return result;
@@ -195,9 +192,15 @@ uint64 Multiply64(uint64 a, uint64 b, uint64 modulo) {
 /**
  * Returns a^n (mod modulo)
  *
- * Note that this version uses uint128, which can be slow.
+ * For odd modulo Montgomery form is used (see Montgomery64),
+ * otherwise Multiply64, which can be slow.
  */
 uint64 PowerModulo64(uint64 a, uint64 n, uint64 modulo) {
+  if (modulo % 2 == 1 && modulo > 1) {
+    const Montgomery64 context(modulo);
+    return context.fromMontgomery(context.power(context.toMontgomery(a), n));
+  }
+
   uint64 result = 1;
   while (n > 0) {
     if (n % 2 != 0)
@@ -208,60 +211,179 @@ uint64 PowerModulo64(uint64 a, uint64 n, uint64 modulo) {
   return result;
 }
 
+namespace detail {
+
 /**
- * Returns vector of divisors of n in increasing order.
+ * Given x = a (mod p) and congruence x = b (mod q), where a and p are
+ * passed reduced modulo q, returns such (k, q / gcd(p, q)) that
+ * a + p * k = b (mod q), with k < q / gcd(p, q).
  *
- * Computational complexity is O(sqrt(n)).
+ * If those congruences are contradictary throws std::runtime_error.
  */
-std::vector<uint32> Divisors(uint32 n) {
-  std::vector<uint32> result;
-  for (uint64 i = 1; i * i <= n; ++i) {
-    if (divides<uint32>(i, n)) {
-      uint32 d = uint32(n / i);
-      result.push_back(uint32(i));
-      if (d != i)
-        result.push_back(d);
-    }
+inline uint64_pair congruence_step(uint64 a, uint64 p, const uint64_pair second) {
+  uint64 b, q;
+  std::tie(b, q) = second;
+  b %= q;
+
+  const uint64 gcd = GCD(p, q);
+  const uint64 difference = (b >= a)? b - a : b + (q - a); // (b - a) mod q
+  if (difference % gcd != 0)
+    throw std::runtime_error("MergeCongruences - contradiction!");
+
+  // We need such k that p * k = b - a (mod q).
+  const uint64 modulo = q / gcd;
+  const uint64 inverse = inverse_modulo(p / gcd, modulo);
+  uint64 k;
+  if (modulo % 2 == 1) {
+    const Montgomery64 context(modulo);
+    k = context.multiply(context.toMontgomery(difference / gcd), inverse);
   }
-  std::sort(result.begin(), result.end());
-  return result;
+  else {
+    k = Multiply64(difference / gcd, inverse, modulo);
+  }
+  return {k, modulo};
 }
 
+} // namespace detail
+
 /**
- * Returns bit_vector of size n.
+ * Merges two congruences using Chinese remainder theorem.
+ * Congruence x = a (mod p) is denoted as pair (a, p).
  *
- * ith bit is on when and only when i is prime number.
+ * If those congruences are contradictary throws std::runtime_error.
+ *
+ * Suppose we have two congruences:
+ * x = a (mod p)
+ * x = b (mod q)
+ * Where a, p, b, q are given.
  *
- * Algorithm used is Eratostenes sieve. For comparison with other sieves
- * see benchmarks.
+ * We want to merge those congruences, ie
+ * find c, r such that congruence
+ * x = c (mod r) is equivalent to two above
+ *
+ * Works for any p, q such that lcm(p, q) fits in uint64, otherwise
+ * throws std::overflow_error. For bigger moduli see ChineseRemainder.
+ */
+uint64_pair MergeCongruences(const uint64_pair first, const uint64_pair second) {
+  uint64 a, p;
+  std::tie(a, p) = first;
+  a %= p;
+  uint64 k, modulo;
+  std::tie(k, modulo) = detail::congruence_step(a % second.second, p % second.second, second);
+  if (p > std::numeric_limits<uint64>::max() / modulo)
+    throw std::overflow_error("MergeCongruences - lcm of moduli does not fit in uint64");
+  return {a + p * k, p * modulo};
+}
+
+/**
+ * Returns result of merging congruences from range [behin, end)
  */
-bit_vector Sieve(uint32 n) {
-  bit_vector V(n, true);
-  V[0] = V[1] = 0;
+template <typename Iterator>
+uint64_pair MergeCongruences(Iterator begin, Iterator end) {
+  uint64_pair result{0, 1};
+  for (const auto& elem: make_range(begin, end)) {
+    result = MergeCongruences(result, elem);
+  }
+  return result;
+}
 
+/**
+ * Merges congruences x = a (mod p) from range [begin, end) of uint64_pair,
+ * like MergeCongruences, but returns (c, r) as pair of BigUnsigned,
+ * so lcm of moduli can be arbitrarily big.
+ *
+ * Each step reduces current c and r modulo next p, which costs
+ * O(size of r), so complexity is O(n^2) limb operations for n congruences.
+ * If congruences are contradictary throws std::runtime_error.
+ *
+ * Example:
+ * <pre>
+ * std::vector<uint64_pair> congruences = {{1, 4294967291}, {2, 4294967279}, {3, 4294967231}};
+ * auto result = ChineseRemainder(congruences.begin(), congruences.end()); // r has 96 bits
+ * </pre>
+ */
+template <typename Iterator>
+std::pair<BigUnsigned, BigUnsigned> ChineseRemainder(Iterator begin, Iterator end) {
+  BigUnsigned c = 0, r = 1;
+  for (const uint64_pair& congruence: make_range(begin, end)) {
+    uint64 k, modulo;
+    std::tie(k, modulo) = detail::congruence_step(c % congruence.second, r % congruence.second, congruence);
+    c += r * BigUnsigned(k);
+    r *= BigUnsigned(modulo);
+  }
+  return {c, r};
+}
 
-  for(uint32 x = 2; x * x < n ; ++x) {
-    if(V[x])
-      for(uint32 y = x * x ; y < n ; y += x)
-        V[y] = 0;
+/**
+ * Returns divisors of number with given factorization, ie list of
+ * prime factors with multiplicities, in which equal primes are adjacent
+ * (as returned by Factorize or SmallestPrimeFactorTable::factorize).
+ *
+ * Divisors are generated prime by prime: divisors found so far are multiplied
+ * by p, p^2, ..., p^k. Complexity is O(d), where d is the number of divisors,
+ * and order is unspecified, unless sorted is true. Then every such layer,
+ * being sorted already, is merged into result, which costs O(d) per prime
+ * factor instead of O(d log d) of sorting.
+ *
+ * Example:
+ * <pre>
+ * DivisorsFromFactorization({2, 2, 3}); // 1, 2, 3, 4, 6, 12
+ * </pre>
+ */
+std::vector<uint32> DivisorsFromFactorization(const std::vector<uint32>& factorization, bool sorted = true) {
+  std::vector<uint32> result = {1};
+  std::vector<uint32> layer, merged;
+  for (size_t i = 0; i < factorization.size(); ) {
+    const uint32 p = factorization[i];
+    layer.assign(result.begin(), result.end());
+    for (; i < factorization.size() && factorization[i] == p; i++) {
+      for (auto& d: layer)
+        d *= p;
+      if (sorted) {
+        merged.resize(result.size() + layer.size());
+        std::merge(result.begin(), result.end(), layer.begin(), layer.end(), merged.begin());
+        result.swap(merged);
+      }
+      else {
+        result.insert(result.end(), layer.begin(), layer.end());
+      }
+    }
   }
+  return result;
+}
 
+/**
+ * Returns bit_vector of size n.
+ *
+ * ith bit is on when and only when i is prime number.
+ *
+ * Algorithm used is segmented Eratostenes sieve over odd numbers,
+ * see numeric/sieve.h. For comparison with other sieves see benchmarks.
+ *
+ * Sieving is split between given number of threads,
+ * 0 stands for std::thread::hardware_concurrency().
+ */
+bit_vector Sieve(uint32 n, uint32 threads = 1) {
+  bit_vector V(n, false);
+  const auto base_primes = detail::sieve_base_primes(n);
+  if (n > 2)
+    V[2] = true;
+  // Chunks start at multiples of 2^19 (hence of 64), so no word of V is shared between threads.
+  detail::parallel_sieve_chunks(0, n, detail::sieve_threads(threads), [&](size_t, uint64 lo, uint64 hi) {
+    detail::segmented_sieve sieve(lo, hi, base_primes);
+    while (sieve.next())
+      sieve.for_each_prime([&V](uint64 p) { V[p] = true; });
+  });
   return V;
 }
 
 /**
  * Returns vector of primes less than n.
+ *
+ * Sieving is split between given number of threads, see Sieve.
  */
-std::vector<uint32> PrimeNumbers(uint32 n) {
-  bit_vector primes = Sieve(n);
-  std::vector<uint32> result;
-  uint32 count = 0;
-  for (uint32 i: range<uint32>(2, n))
-    if (primes[i]) count++;
-  result.reserve(count);
-  for (uint32 i: range<uint32>(2, n))
-    if (primes[i]) result.push_back(i);
-  return result;
+std::vector<uint32> PrimeNumbers(uint32 n, uint32 threads = 1) {
+  return detail::parallel_prime_numbers<uint32>(0, n, threads);
 }
 
 constexpr uint64 kPrimesPreprocessedNumber = 1 * 1000 * 1000;
@@ -270,9 +392,14 @@ constexpr uint64 kMaxFactorizableNumber = kPrimesPreprocessedNumber * kPrimesPre
 /**
  * Returns factorization of n. Uses preprocessed primes to speed up factorization.
  *
- * Computational complexity is O(sqrt(n) / log n).
+ * Computational complexity is O(sqrt(n) / log n), or O(log n)
+ * if n is covered by global SmallestPrimeFactorTable.
  */
 std::vector<uint32> Factorize(uint32 n) {
+  const auto* table = GlobalSmallestPrimeFactorTable();
+  if (table != nullptr && n != 0 && table->contains(n))
+    return table->factorize(n);
+
   static std::vector<uint32> primes = PrimeNumbers(kPrimesPreprocessedNumber);
   std::vector<uint32> result;
   for (const uint64 p: primes) {
@@ -289,8 +416,23 @@ std::vector<uint32> Factorize(uint32 n) {
   return result;
 }
 
+/**
+ * Returns vector of divisors of n in increasing order.
+ *
+ * Divisors are generated from factorization of n, see DivisorsFromFactorization.
+ * Computational complexity is O(sqrt(n) / log n), or O(number of divisors)
+ * if n is covered by global SmallestPrimeFactorTable.
+ */
+std::vector<uint32> Divisors(uint32 n) {
+  if (n == 0)
+    return {};
+  return DivisorsFromFactorization(Factorize(n));
+}
+
 /**
  * Returns prime divisors of n.
+ *
+ * Uses global SmallestPrimeFactorTable if it is built, see Factorize.
  */
 std::vector<uint32> PrimeDivisors(uint32 n) {
   auto divisors = Factorize(n);
@@ -300,8 +442,133 @@ std::vector<uint32> PrimeDivisors(uint32 n) {
 
 namespace detail {
 
+/**
+ * Lucy_Hedgehog's dynamic programming over values v = floor(n / k).
+ *
+ * For completely multiplicative f, given prefix(v) = f(2) + ... + f(v)
+ * and function(p) = f(p), computes sum of f(p) over primes p <= v
+ * for every v of form floor(n / k). There are at most 2 sqrt(n) such values:
+ * small_[v] holds result for v <= sqrt(n) and large_[k] for v = floor(n / k).
+ *
+ * Starting from prefix, primes up to sqrt(n) are taken from sieve in increasing
+ * order and prime p removes numbers with smallest prime factor p from every
+ * v >= p^2, using S(v) -= f(p) * (S(v / p) - S(p - 1)).
+ * Complexity is O(n^(3/4) / log n), memory is O(sqrt(n)).
+ */
+template <typename Value>
+class lucy_table {
+public:
+  template <typename Prefix, typename Function>
+  lucy_table(uint64 n, Prefix prefix, Function function):
+      n_(n), root_(SquareFloor(n)), small_(root_ + 1, Value(0)), large_(root_ + 1, Value(0)) {
+    std::vector<uint64> quotients(root_ + 1, 0);
+    for (uint64 v = 1; v <= root_; v++)
+      small_[v] = prefix(v);
+    for (uint64 k = 1; k <= root_; k++) {
+      quotients[k] = n_ / k;
+      large_[k] = prefix(quotients[k]);
+    }
+
+    for (const uint64 p: PrimeNumbers(uint32(root_ + 1))) {
+      const Value before = small_[p - 1];
+      const Value value = function(p);
+      const uint64 square = p * p;
+      const double inverse = 1.0 / double(p);
+      // large_[k * p] is not updated yet, as k * p > k
+      const uint64 bound = std::min(root_, n_ / square);
+      const uint64 middle = std::min(bound, root_ / p);
+      for (uint64 k = 1; k <= middle; k++)
+        large_[k] -= value * (large_[k * p] - before);
+      for (uint64 k = middle + 1; k <= bound; k++)
+        large_[k] -= value * (small_[divide(quotients[k], p, inverse)] - before);
+      for (uint64 v = root_; v >= square; v--)
+        small_[v] -= value * (small_[divide(v, p, inverse)] - before);
+    }
+  }
+
+  /**
+   * Returns sum of f(p) over primes p <= v, v must be of form floor(n / k).
+   */
+  Value operator()(uint64 v) const {
+    return (v <= root_)? small_[v] : large_[n_ / v];
+  }
+
+private:
+  /**
+   * Returns v / p, using multiplication by inverse = 1.0 / p, which
+   * is off by at most one for v < 2^53, instead of slow 64-bit division.
+   */
+  static uint64 divide(uint64 v, uint64 p, double inverse) {
+    uint64 result = uint64(double(v) * inverse);
+    if (result * p > v)
+      result--;
+    else if (v - result * p >= p)
+      result++;
+    return result;
+  }
+
+  uint64 n_;
+  uint64 root_;
+  std::vector<Value> small_;
+  std::vector<Value> large_;
+};
+
+} // namespace detail
+
+/**
+ * Returns number of primes p <= n.
+ *
+ * Uses Lucy_Hedgehog's algorithm, so range is never sieved as a whole:
+ * only primes up to sqrt(n) are sieved. Complexity is O(n^(3/4) / log n),
+ * memory is O(sqrt(n)): three tables of sqrt(n) 64-bit values, for n = 10^12
+ * that is around 24 MB.
+ *
+ * Example:
+ * <pre>
+ * PrimeCount(1000uLL * 1000 * 1000 * 1000); // 37607912018
+ * </pre>
+ */
+uint64 PrimeCount(uint64 n) {
+  const detail::lucy_table<uint64> table(n, [](uint64 v) { return v - 1; }, [](uint64) { return uint64(1); });
+  return table(n);
+}
+
+/**
+ * Returns sum of primes p <= n as Value.
+ *
+ * Value must be a ring constructible from uint64, like uint64 (arithmetic
+ * modulo 2^64, exact for n up to 2 * 10^10), unsigned __int128 (available
+ * when HAVE_INT128_TYPES is defined, exact for every n) or prime_field.
+ * Complexity is the same as of PrimeCount, tables hold Value instead of uint64.
+ *
+ * Example:
+ * <pre>
+ * PrimeSum(2000000); // 142913828922
+ * PrimeSum<unsigned __int128>(1000uLL * 1000 * 1000 * 1000); // 18435588552550705911377
+ * PrimeSum<prime_field<1000000007>>(1000uLL * 1000 * 1000 * 1000);
+ * </pre>
+ */
+template <typename Value = uint64>
+Value PrimeSum(uint64 n) {
+  const detail::lucy_table<Value> table(n, [](uint64 v) {
+    uint64 a = v, b = v + 1;
+    if (a % 2 == 0)
+      a /= 2;
+    else
+      b /= 2;
+    return Value(a) * Value(b) - Value(1);
+  }, [](uint64 p) {
+    return Value(p);
+  });
+  return table(n);
+}
+
+namespace detail {
+
 /**
  * Performs miller rabin test on p with given set of witnesses.
+ *
+ * Computations are done in Montgomery form, see Montgomery64.
 */
 template<uint64... Witnesses>
 struct MillerRabinPrimeTest {
@@ -312,27 +579,33 @@ struct MillerRabinPrimeTest {
       if (p == witness)
         return true;
 
+    if (p % 2 == 0)
+      return false;
+
+    const Montgomery64 context(p);
+    const uint64 one = context.one();
+    const uint64 minus_one = context.subtract(0, one);
     const uint64 odd_factor = (p - 1uLL) / (1uLL << least_significant_one(p - 1));
 
     for (const auto witness: witnesses) {
       uint64 k = odd_factor;
-      uint64 x = PowerModulo64(witness, k, p);
+      uint64 x = context.power(context.toMontgomery(witness), k);
 
-      if (x == 1 || x == (p - 1))
+      if (x == one || x == minus_one)
         continue;
 
       while (k < p - 1) {
-        x = Multiply64(x, x, p);
+        x = context.multiply(x, x);
 
-        if (x == (p - 1))
+        if (x == minus_one)
           break;
-        else if (x == 1)
+        else if (x == one)
           return false;
 
         k *= 2;
       }
 
-      if (x != p - 1)
+      if (x != minus_one)
         return false;
     }
     return true;
@@ -365,21 +638,388 @@ bool IsPrime(uint64 p)
     return big.test(p);
 }
 
+namespace detail {
+
+constexpr uint32 kPrimalityLanes = 4;
+constexpr size_t kPrimalityBatchChunk = 1 << 14;
+
+/**
+ * Checks divisibility of n by primes smaller than 60.
+ * Returns 1 if n is prime, 0 if n is composite
+ * and -1 if Miller-Rabin test is needed.
+ */
+inline int small_primes_filter(uint64 n) {
+  static constexpr uint32 primes[] = {3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59};
+  if (n % 2 == 0)
+    return n == 2;
+  for (const uint32 p: primes)
+    if (n % p == 0)
+      return n == p;
+  return (n >= 61 * 61)? -1 : (n > 1);
+}
+
+/**
+ * Performs Miller-Rabin test on kPrimalityLanes odd numbers bigger than
+ * all witnesses at once. Multiplications modulo different numbers
+ * are independent, so interleaving them hides their latency.
+ */
+template <size_t Witnesses>
+void miller_rabin_lanes(const uint64 (&numbers)[kPrimalityLanes],
+                        const uint64 (&witnesses)[Witnesses],
+                        bool (&result)[kPrimalityLanes]) {
+  static_assert(kPrimalityLanes == 4, "miller_rabin_lanes - update contexts initialization");
+  constexpr uint32 L = kPrimalityLanes;
+  const Montgomery64 context[L] = {
+      Montgomery64(numbers[0]), Montgomery64(numbers[1]),
+      Montgomery64(numbers[2]), Montgomery64(numbers[3])
+  };
+
+  uint64 odd_factor[L], minus_one[L];
+  uint32 exponent[L];
+  uint64 max_odd_factor = 0;
+  uint32 max_exponent = 0;
+  for (uint32 i = 0; i < L; i++) {
+    result[i] = true;
+    exponent[i] = least_significant_one(numbers[i] - 1);
+    odd_factor[i] = (numbers[i] - 1) >> exponent[i];
+    minus_one[i] = context[i].subtract(0, context[i].one());
+    max_odd_factor = std::max(max_odd_factor, odd_factor[i]);
+    max_exponent = std::max(max_exponent, exponent[i]);
+  }
+
+  for (const uint64 witness: witnesses) {
+    uint64 x[L], base[L];
+    for (uint32 i = 0; i < L; i++) {
+      x[i] = context[i].one();
+      base[i] = context[i].toMontgomery(witness);
+    }
+    for (uint64 bit = 1; bit != 0 && bit <= max_odd_factor; bit <<= 1) {
+      for (uint32 i = 0; i < L; i++) {
+        if (odd_factor[i] & bit)
+          x[i] = context[i].multiply(x[i], base[i]);
+        base[i] = context[i].multiply(base[i], base[i]);
+      }
+    }
+
+    bool pending[L];
+    for (uint32 i = 0; i < L; i++)
+      pending[i] = result[i] && x[i] != context[i].one() && x[i] != minus_one[i];
+    for (uint32 round = 1; round < max_exponent; round++) {
+      for (uint32 i = 0; i < L; i++) {
+        if (pending[i] && round < exponent[i]) {
+          x[i] = context[i].multiply(x[i], x[i]);
+          pending[i] = (x[i] != minus_one[i]);
+        }
+      }
+    }
+    bool any_prime = false;
+    for (uint32 i = 0; i < L; i++) {
+      if (pending[i])
+        result[i] = false;
+      any_prime |= result[i];
+    }
+    if (!any_prime)
+      return;
+  }
+}
+
+/**
+ * Collects numbers tested with the same witnesses
+ * and tests them kPrimalityLanes at once.
+ */
+template <size_t Witnesses>
+class miller_rabin_batch {
+public:
+  explicit miller_rabin_batch(const uint64 (&witnesses)[Witnesses]):
+      witnesses_(witnesses), size_(0) { }
+
+  void push(uint64 n, bool* result) {
+    numbers_[size_] = n;
+    results_[size_++] = result;
+    if (size_ == kPrimalityLanes)
+      flush();
+  }
+
+  void flush() {
+    if (size_ == 0)
+      return;
+    for (uint32 i = size_; i < kPrimalityLanes; i++)
+      numbers_[i] = numbers_[0];
+    bool result[kPrimalityLanes];
+    miller_rabin_lanes(numbers_, witnesses_, result);
+    for (uint32 i = 0; i < size_; i++)
+      *results_[i] = result[i];
+    size_ = 0;
+  }
+
+private:
+  const uint64 (&witnesses_)[Witnesses];
+  uint64 numbers_[kPrimalityLanes];
+  bool* results_[kPrimalityLanes];
+  uint32 size_;
+};
+
+inline void is_prime_batch(const uint64* numbers, size_t count, bool* result) {
+  static constexpr uint64 first_witness[] = {2};
+  static constexpr uint64 small_witnesses[] = {7, 61};
+  static constexpr uint64 big_witnesses[] = {3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+  constexpr uint64 threshold = 4759123141;
+
+  // Almost all composites fail test for witness 2, so other
+  // witnesses are tried only for numbers which passed it.
+  miller_rabin_batch<1> first(first_witness);
+  for (size_t i = 0; i < count; i++) {
+    const int filter = small_primes_filter(numbers[i]);
+    if (filter >= 0)
+      result[i] = (filter == 1);
+    else
+      first.push(numbers[i], result + i);
+  }
+  first.flush();
+
+  miller_rabin_batch<2> small(small_witnesses);
+  miller_rabin_batch<11> big(big_witnesses);
+  for (size_t i = 0; i < count; i++) {
+    if (!result[i] || numbers[i] < 61 * 61)
+      continue;
+    if (numbers[i] < threshold)
+      small.push(numbers[i], result + i);
+    else
+      big.push(numbers[i], result + i);
+  }
+  small.flush();
+  big.flush();
+}
+
+} // namespace detail
+
+/**
+ * Tests primality of numbers from range [numbers, numbers + count),
+ * result[i] is set to IsPrime(numbers[i]).
+ *
+ * Numbers with small prime factors are rejected by trial division,
+ * remaining ones are tested by Miller-Rabin test interleaved over
+ * several numbers, which is a few times faster than calling IsPrime
+ * in a loop. Large batches are split into chunks tested by given
+ * number of threads (0 means all hardware threads).
+ *
+ * Example:
+ * <pre>
+ * std::vector<uint64> candidates = ...;
+ * std::unique_ptr<bool[]> prime(new bool[candidates.size()]);
+ * IsPrimeBatch(candidates.data(), candidates.size(), prime.get(), 0);
+ * </pre>
+ */
+void IsPrimeBatch(const uint64* numbers, size_t count, bool* result, uint32 threads = 1) {
+  threads = detail::sieve_threads(threads);
+  constexpr size_t kChunk = detail::kPrimalityBatchChunk;
+  if (threads == 1 || count <= kChunk) {
+    detail::is_prime_batch(numbers, count, result);
+    return;
+  }
+
+  detail::parallel_chunks((count + kChunk - 1) / kChunk, threads, [&](size_t i) {
+    const size_t first = i * kChunk;
+    detail::is_prime_batch(numbers + first, std::min(kChunk, count - first), result + first);
+  });
+}
+
+namespace detail {
+
+/**
+ * Returns nontrivial divisor of odd composite n, or n on failure.
+ *
+ * Pollard's rho algorithm with Brent's cycle detection, iterating
+ * x -> x^2 + c in Montgomery form. Differences are multiplied
+ * in batches, so that single gcd is computed per batch.
+ */
+inline uint64 pollard_rho_brent(uint64 n, uint64 seed) {
+  constexpr uint64 kBatchSize = 128;
+  const Montgomery64 context(n);
+  const uint64 c = context.toMontgomery(seed);
+  auto f = [&](uint64 x) { return context.add(context.multiply(x, x), c); };
+
+  uint64 x = 0, y = context.toMontgomery(seed + 1), ys = y;
+  uint64 q = context.one();
+  uint64 g = 1;
+  for (uint64 r = 1; g == 1; r *= 2) {
+    x = y;
+    for (uint64 i = 0; i < r; i++)
+      y = f(y);
+    for (uint64 k = 0; k < r && g == 1; k += kBatchSize) {
+      ys = y;
+      for (uint64 i = 0; i < std::min(kBatchSize, r - k); i++) {
+        y = f(y);
+        q = context.multiply(q, context.subtract(x, y));
+      }
+      // Montgomery form is a * 2^64, so gcd with n is not affected.
+      g = GCD(q, n);
+    }
+  }
+
+  if (g == n) {
+    // Whole batch collapsed, repeat it step by step.
+    do {
+      ys = f(ys);
+      g = GCD(context.subtract(x, ys), n);
+    } while (g == 1);
+  }
+  return g;
+}
+
+/**
+ * Appends prime factors of n (in any order) to result.
+ */
+inline void factorize_pollard(uint64 n, std::vector<uint64>& result) {
+  if (n == 1)
+    return;
+  if (IsPrime(n)) {
+    result.push_back(n);
+    return;
+  }
+  uint64 divisor = n;
+  for (uint64 seed = 1; divisor == n; seed++)
+    divisor = pollard_rho_brent(n, seed);
+  factorize_pollard(divisor, result);
+  factorize_pollard(n / divisor, result);
+}
+
+} // namespace detail
+
+/**
+ * Returns factorization of 64-bit n in increasing order.
+ *
+ * Small factors are found by trial division, remaining ones
+ * by Pollard's rho algorithm (see detail::pollard_rho_brent), so
+ * expected complexity is O(n^(1/4)) multiplications. Uses global
+ * SmallestPrimeFactorTable if it covers n.
+ *
+ * Throws std::invalid_argument for 0.
+ */
+std::vector<uint64> Factorize64(uint64 n) {
+  constexpr uint32 kTrialDivisionBound = 1u << 10;
+  if (n == 0)
+    throw std::invalid_argument("Factorize64 - cannot factorize 0");
+
+  std::vector<uint64> result;
+  const auto* table = GlobalSmallestPrimeFactorTable();
+  if (table != nullptr && table->contains(n)) {
+    for (auto p: table->factorize(uint32(n)))
+      result.push_back(p);
+    return result;
+  }
+
+  static const std::vector<uint32> small_primes = PrimeNumbers(kTrialDivisionBound);
+  for (const uint64 p: small_primes) {
+    if (p * p > n)
+      break;
+    while (n % p == 0) {
+      result.push_back(p);
+      n /= p;
+    }
+  }
+  if (n < uint64(kTrialDivisionBound) * kTrialDivisionBound) {
+    if (n > 1)
+      result.push_back(n);
+    return result;
+  }
+
+  const size_t small_factors = result.size();
+  detail::factorize_pollard(n, result);
+  std::sort(result.begin() + small_factors, result.end());
+  return result;
+}
+
+/**
+ * Answers primitive root and multiplicative order queries modulo prime p.
+ *
+ * Factorization of p - 1 is computed once, in constructor, so that
+ * each query costs O(log^2 p) instead of factorizing p - 1 again.
+ *
+ * Example:
+ * <pre>
+ * PrimitiveRootFinder finder(998244353);
+ * finder.find(); // 3
+ * finder.isPrimitiveRoot(5); // true
+ * finder.order(998244352); // 2
+ * </pre>
+ */
+class PrimitiveRootFinder {
+public:
+  /**
+   * Prepares finder for p, which must be a prime number.
+   */
+  explicit PrimitiveRootFinder(uint32 p):
+      p_(p), factorization_(Factorize(p - 1)), prime_divisors_(factorization_) {
+    prime_divisors_.erase(std::unique(prime_divisors_.begin(), prime_divisors_.end()), prime_divisors_.end());
+  }
+
+  uint32 prime() const {
+    return p_;
+  }
+
+  /**
+   * Returns factorization of p - 1.
+   */
+  const std::vector<uint32>& factorization() const {
+    return factorization_;
+  }
+
+  /**
+   * Returns true if g is primitive root modulo p.
+   */
+  bool isPrimitiveRoot(uint32 g) const {
+    if (divides(p_, g))
+      return false;
+    for (auto q: prime_divisors_) {
+      if (PowerModulo32(g, (p_ - 1) / q, p_) == 1)
+        return false;
+    }
+    return true;
+  }
+
+  /**
+   * Returns smallest primitive root modulo p.
+   */
+  uint32 find() const {
+    uint32 g = 1;
+    while (!isPrimitiveRoot(g))
+      g++;
+    return g;
+  }
+
+  /**
+   * Returns multiplicative order of a (mod p), found by dividing p - 1
+   * by its prime factors q as long as a^((p - 1) / q) = 1.
+   *
+   * If a is 0 (mod p) throws an exception of type std::runtime_error.
+   */
+  uint32 order(uint32 a) const {
+    if (divides(p_, a))
+      throw std::runtime_error("PrimitiveRootFinder - argument is 0 (mod p)!");
+    uint32 result = p_ - 1;
+    for (auto q: prime_divisors_) {
+      while (result % q == 0 && PowerModulo32(a, result / q, p_) == 1)
+        result /= q;
+    }
+    return result;
+  }
+
+private:
+  uint32 p_;
+  std::vector<uint32> factorization_;
+  std::vector<uint32> prime_divisors_;
+};
+
 /**
  * Returns true if g is primitive root modulo p.
  * Note that p must be prime.
  * Also note that g and p are 32 bits unsigned integers.
+ *
+ * To test many candidates for the same p use PrimitiveRootFinder.
  */
 bool IsPrimitiveRoot(uint32 g, uint32 p) {
-  if (divides(p, g))
-    return false;
-
-  auto prime_divisors = PrimeDivisors(p - 1);
-  for (auto d: prime_divisors) {
-    if (PowerModulo32(g, (p - 1) / d, p) == 1)
-      return false;
-  }
-  return true;
+  return PrimitiveRootFinder(p).isPrimitiveRoot(g);
 }
 
 /**
@@ -392,52 +1032,280 @@ uint32 Inverse(uint32 n, uint32 p) {
   return PowerModulo32(n, p - 2, p);
 }
 
+/**
+ * Returns inverses of all values, which must be nonzero elements of a field
+ * (prime_field, dynamic_field, montgomery_field).
+ *
+ * Uses Montgomery's trick: prefix products are inverted with single call
+ * to inverse and then unwound, so the cost is one inversion and 3n multiplications.
+ * If any value is zero throws an exception of type std::runtime_error.
+ *
+ * Example:
+ * <pre>
+ * using field = prime_field<1000000007>;
+ * auto inverses = BatchInverse(std::vector<field>{1, 2, 3}); // 1, 500000004, 333333336
+ * </pre>
+ */
+template <typename Value>
+std::vector<Value> BatchInverse(const std::vector<Value>& values) {
+  std::vector<Value> result(values.size());
+  Value product = 1;
+  for (size_t i = 0; i < values.size(); i++) {
+    result[i] = product;
+    product *= values[i];
+  }
+  Value inverse_product = inverse(product);
+  for (size_t i = values.size(); i-- > 0; ) {
+    result[i] *= inverse_product;
+    inverse_product *= values[i];
+  }
+  return result;
+}
+
 /**
  * Returns multiplicative order of a (mod p).
  *
  * If a is 0 (mod p) throws an exception of type std::runtime_error.
  * Note that p must be a prime number.
  * Also note that n and p are 32 bits unsigned integers.
+ * Uses global SmallestPrimeFactorTable if it is built, see Factorize.
  */
 uint32 MultiplicativeOrder(uint32 a, uint32 p) {
   if (divides(p, a))
     throw std::runtime_error("MultiplicativeOrder - argument is 0 (mod p)!");
+  return PrimitiveRootFinder(p).order(a);
+}
 
-  auto divisors = Divisors(p - 1);
-  for (auto d: divisors) {
-    if (PowerModulo32(a, d, p) == 1)
-      return d;
+namespace detail {
+
+/**
+ * Open addressing hash table from nonzero uint32 keys to uint32 values,
+ * used for baby steps. Kept at most half full, with linear probing
+ * over one flat array, so lookup usually touches single cache line.
+ */
+class baby_step_table {
+public:
+  baby_step_table():
+      shift_(31), entries_(2) { }
+
+  /**
+   * Constructs empty table for given number of entries.
+   */
+  explicit baby_step_table(size_t size) {
+    const uint32 bits = std::max<uint32>(1, most_significant_one(2 * size + 1) + 1);
+    shift_ = 32 - bits;
+    entries_.assign(size_t(1) << bits, entry{0, 0});
   }
-  assert(0 && "Impossible to reach.");
-}
+
+  /**
+   * Inserts key with value, if key is not present yet. Key must not be 0.
+   */
+  void insert(uint32 key, uint32 value) {
+    for (size_t i = slot(key); ; i = next(i)) {
+      if (entries_[i].key == key)
+        return;
+      if (entries_[i].key == 0) {
+        entries_[i] = entry{key, value};
+        return;
+      }
+    }
+  }
+
+  /**
+   * Returns true and sets value if key is present.
+   */
+  bool find(uint32 key, uint32& value) const {
+    for (size_t i = slot(key); entries_[i].key != 0; i = next(i)) {
+      if (entries_[i].key == key) {
+        value = entries_[i].value;
+        return true;
+      }
+    }
+    return false;
+  }
+
+private:
+  struct entry {
+    uint32 key;
+    uint32 value;
+  };
+
+  size_t slot(uint32 key) const {
+    return uint32(key * 0x9E3779B1u) >> shift_;
+  }
+
+  size_t next(size_t i) const {
+    return (i + 1) & (entries_.size() - 1);
+  }
+
+  uint32 shift_;
+  std::vector<entry> entries_;
+};
+
+} // namespace detail
+
+/**
+ * Solver of discrete logarithms in base a modulo prime p,
+ * for many queries with the same a and p.
+ *
+ * Constructor factorizes p - 1 and order of a, and for each prime q
+ * dividing the order builds table of baby steps in subgroup of order q.
+ * Queries use Pohlig-Hellman reduction to these subgroups, so they cost
+ * O(sum of e * sqrt(q)) over prime powers q^e dividing order of a,
+ * which is very fast when p - 1 is smooth and O(sqrt(p)) at worst.
+ *
+ * Number of baby steps in subgroup of order q is ceil(table_factor * sqrt(q)),
+ * number of giant steps is q divided by it. For k queries table_factor
+ * around sqrt(k) minimizes total time, at cost of bigger tables.
+ *
+ * Example:
+ * <pre>
+ * DiscreteLogSolver solver(3, 1000000007);
+ * uint32 k = solver.logarithm(123456); // 3^k = 123456 (mod 1000000007)
+ * </pre>
+ */
+class DiscreteLogSolver {
+public:
+  /**
+   * Prepares solver for base a modulo prime p.
+   *
+   * If a is 0 (mod p) throws an exception of type std::runtime_error.
+   */
+  DiscreteLogSolver(uint32 a, uint32 p, double table_factor = 1.0):
+      barrett_(p), base_(a % p), order_(p - 1) {
+    if (base_ == 0)
+      throw std::runtime_error("DiscreteLogSolver - base is 0 (mod p)!");
+
+    const auto prime_divisors = PrimeDivisors(p - 1);
+    for (uint32 q: prime_divisors) {
+      while (order_ % q == 0 && power(base_, order_ / q) == 1)
+        order_ /= q;
+    }
+
+    for (uint32 q: prime_divisors) {
+      if (order_ % q != 0)
+        continue;
+      subgroup group;
+      group.prime = q;
+      group.exponent = 0;
+      group.prime_power = 1;
+      while (order_ % (uint64(group.prime_power) * q) == 0) {
+        group.prime_power *= q;
+        group.exponent++;
+      }
+      group.cofactor = order_ / group.prime_power;
+      group.base = power(base_, group.cofactor);
+      group.inverse_base = uint32(detail::inverse_modulo(group.base, p));
+      const uint32 generator = power(group.base, group.prime_power / q); // order q
+
+      const double steps = std::ceil(table_factor * std::sqrt(double(q)));
+      group.baby_steps = uint32(std::max(1.0, std::min(steps, double(q))));
+      group.table = detail::baby_step_table(group.baby_steps);
+      uint32 value = 1;
+      for (uint32 j = 0; j < group.baby_steps; j++) {
+        group.table.insert(value, j);
+        value = barrett_.multiply(value, generator);
+      }
+      group.giant_step = uint32(detail::inverse_modulo(value, p));
+      subgroups_.push_back(std::move(group));
+    }
+  }
+
+  /**
+   * Returns order of base.
+   */
+  uint32 order() const {
+    return order_;
+  }
+
+  /**
+   * Returns smallest k such that a^k = x (mod p).
+   *
+   * If x is not in orbit of a throws an exception of type std::runtime_error.
+   */
+  uint32 logarithm(uint32 x) const {
+    x %= modulus();
+    if (x == 0 || power(x, order_) != 1)
+      throw std::runtime_error("DiscreteLogSolver - no logarithm found");
+
+    uint64_pair result(0, 1);
+    for (const auto& group: subgroups_) {
+      // Finds k < q^e digit by digit, each digit is logarithm in subgroup of order q.
+      const uint32 target = power(x, group.cofactor);
+      uint32 k = 0, digit_weight = 1;
+      for (uint32 i = 0; i < group.exponent; i++) {
+        const uint32 rest = barrett_.multiply(target, power(group.inverse_base, k));
+        const uint32 digit = subgroupLogarithm(group, power(rest, group.prime_power / digit_weight / group.prime));
+        k += digit * digit_weight;
+        digit_weight *= group.prime;
+      }
+      result = MergeCongruences(result, uint64_pair(k, group.prime_power));
+    }
+    return uint32(result.first);
+  }
+
+private:
+  struct subgroup {
+    uint32 prime;
+    uint32 exponent;
+    uint32 prime_power;
+    uint32 cofactor;     /// order / prime_power
+    uint32 base;         /// a^cofactor, of order prime_power
+    uint32 inverse_base;
+    uint32 baby_steps;
+    uint32 giant_step;   /// generator^-baby_steps
+    detail::baby_step_table table;
+  };
+
+  uint32 modulus() const {
+    return barrett_.modulus();
+  }
+
+  uint32 power(uint32 a, uint64 n) const {
+    uint32 result = 1 % modulus();
+    while (n > 0) {
+      if (n % 2 == 1)
+        result = barrett_.multiply(result, a);
+      n /= 2;
+      if (n > 0)
+        a = barrett_.multiply(a, a);
+    }
+    return result;
+  }
+
+  /**
+   * Baby-step giant-step in subgroup of order q, x must belong to it.
+   */
+  uint32 subgroupLogarithm(const subgroup& group, uint32 x) const {
+    uint32 j;
+    for (uint32 i = 0; i * uint64(group.baby_steps) < group.prime; i++) {
+      if (group.table.find(x, j))
+        return i * group.baby_steps + j;
+      x = barrett_.multiply(x, group.giant_step);
+    }
+    throw std::runtime_error("DiscreteLogSolver - no logarithm found");
+  }
+
+  Barrett32 barrett_;
+  uint32 base_;
+  uint32 order_;
+  std::vector<subgroup> subgroups_;
+};
 
 /**
  * Calculates discrete logarithm of x in the base of a modulo p.
  *
  * If x is not in orbit of a throws an exception of type std::runtime_error.
  *
- * Uses baby-step giant-step algoritm, computational complexity is O(sqrt(p))
+ * Uses DiscreteLogSolver, computational complexity is O(sqrt(p)) at worst
+ * and much lower if p - 1 is smooth. Use DiscreteLogSolver directly
+ * for many queries with the same a and p.
  *
  * Note that p must be a prime number.
  * Also note that a, x, and p are 32 bits unsigned integers.
  */
 uint32 DiscreteLogarithm(const uint32 a, uint32 x, const uint32 p) {
-  const uint32 order_of_a = MultiplicativeOrder(a, p);
-  const uint32 sqrt = uint64(SquareCeiling(p - 1));
-  std::unordered_map<uint32, uint32> small_steps;
-  for (auto i: range<uint32>(0, sqrt))
-    small_steps.emplace(PowerModulo32(a, i, p), i);
-
-  uint32 giant_step = Inverse(PowerModulo32(a, sqrt, p), p);
-
-  for (auto i: range<uint32>(0, sqrt)) {
-    auto it = small_steps.find(x);
-    if (it != small_steps.end()) {
-      return (uint64(it->second) + uint64(i) * sqrt) % order_of_a;
-    }
-    x = Multiply32(x, giant_step, p);
-  }
-  throw std::runtime_error("DiscreteLogarithm - no logarithm found");
+  return DiscreteLogSolver(a, p).logarithm(x);
 }
 
 } // namespace numeric
@@ -0,0 +1,378 @@
+#pragma once
+// Jakub Staroń, 2016-2017
+
+#include "headers.h"
+#include "numeric/ntt.h"
+#include "numeric/prime_field.h"
+
+namespace pcl {
+namespace numeric {
+
+namespace detail {
+
+/**
+ * Scratch buffers of power series routines, shared by all calls
+ * of current thread, so that repeated calls don't reallocate.
+ *
+ * Buffers first and second are used only by leaf routines
+ * (transforms and products), the other ones hold intermediate
+ * series and are owned by single routine at a time.
+ */
+template <uint32 prime>
+struct series_workspace {
+  using field = prime_field<prime>;
+
+  std::vector<field> first;
+  std::vector<field> second;
+  std::vector<field> inverse;     /// used by log, sqrt and division
+  std::vector<field> product;     /// used by log, sqrt and division
+  std::vector<field> logarithm;   /// used by exp and division
+  std::vector<field> reciprocals; /// 1/i, used for integration
+
+  static series_workspace& get() {
+    static thread_local series_workspace workspace;
+    return workspace;
+  }
+};
+
+/**
+ * Returns smallest power of two not smaller than n, checking that
+ * transform of such size is possible modulo prime.
+ */
+template <uint32 prime>
+size_t series_transform_size(size_t n) {
+  size_t size = 1;
+  while (size < n)
+    size *= 2;
+  if (size > ntt_tables<prime>::maxSize())
+    throw std::invalid_argument("power series - length too big for prime");
+  return size;
+}
+
+/**
+ * Stores forward transform (in bit-reversed order) of values[0, count)
+ * padded with zeros to size n in result.
+ */
+template <uint32 prime>
+void series_transform(const prime_field<prime>* values, size_t count, size_t n,
+                      std::vector<prime_field<prime>>& result) {
+  result.assign(n, 0);
+  std::copy(values, values + std::min(count, n), result.begin());
+  ntt_decimation_in_frequency(result.data(), n, ntt_tables<prime>::roots(n).data());
+}
+
+/**
+ * Inverts series_transform in place.
+ */
+template <uint32 prime>
+void series_inverse_transform(prime_field<prime>* values, size_t n) {
+  using field = prime_field<prime>;
+  ntt_decimation_in_time(values, n, ntt_tables<prime>::roots(n).data());
+  std::reverse(values + 1, values + n);
+  const field scale = inverse(field(n));
+  for (size_t i = 0; i < n; i++)
+    values[i] *= scale;
+}
+
+/**
+ * Stores first n coefficients of product of a[0, na) and b[0, nb) in result[0, n).
+ * Result may overlap with a or b.
+ */
+template <uint32 prime>
+void series_multiply(const prime_field<prime>* a, size_t na, const prime_field<prime>* b, size_t nb,
+                     size_t n, prime_field<prime>* result) {
+  auto& workspace = series_workspace<prime>::get();
+  auto& first = workspace.first;
+  auto& second = workspace.second;
+  na = std::min(na, n);
+  nb = std::min(nb, n);
+  if (na == 0 || nb == 0) {
+    std::fill(result, result + n, 0);
+    return;
+  }
+
+  if (std::min(na, nb) <= kNaiveConvolutionThreshold) {
+    first.assign(n, 0);
+    for (size_t i = 0; i < na; i++)
+      for (size_t j = 0; j < nb && i + j < n; j++)
+        first[i + j] += a[i] * b[j];
+    std::copy(first.begin(), first.begin() + n, result);
+    return;
+  }
+
+  const size_t size = series_transform_size<prime>(na + nb - 1);
+  series_transform(a, na, size, first);
+  if (a == b && na == nb) {
+    for (auto& value: first)
+      value *= value;
+  }
+  else {
+    series_transform(b, nb, size, second);
+    for (size_t i = 0; i < size; i++)
+      first[i] *= second[i];
+  }
+  series_inverse_transform(first.data(), size);
+  const size_t exact = std::min(n, na + nb - 1);
+  std::copy(first.begin(), first.begin() + exact, result);
+  std::fill(result + exact, result + n, 0);
+}
+
+/**
+ * Returns table of 1/i for i < n, valid until next call.
+ */
+template <uint32 prime>
+const prime_field<prime>* series_reciprocals(size_t n) {
+  auto& reciprocals = series_workspace<prime>::get().reciprocals;
+  if (reciprocals.size() < 2)
+    reciprocals = {0, 1};
+  while (reciprocals.size() < n) {
+    const uint32 i = uint32(reciprocals.size());
+    reciprocals.push_back((0 - reciprocals[prime % i]) * (prime / i));
+  }
+  return reciprocals.data();
+}
+
+/**
+ * Stores first n coefficients of 1/a in result, for a[0] != 0.
+ *
+ * Newton iteration b' = b (2 - a b) doubles number of correct coefficients.
+ * Step takes five transforms of size 2m: a and b forward, a b back,
+ * a b - 1 with lower half (known to be zero) cleared forward again,
+ * and product with b back.
+ */
+template <uint32 prime>
+void series_inverse(const prime_field<prime>* a, size_t count, size_t n,
+                    std::vector<prime_field<prime>>& result) {
+  using field = prime_field<prime>;
+  auto& workspace = series_workspace<prime>::get();
+  auto& first = workspace.first;
+  auto& second = workspace.second;
+  const field head = inverse(a[0]);
+
+  if (n <= kNaiveConvolutionThreshold) {
+    result.assign(n, 0);
+    result[0] = head;
+    for (size_t i = 1; i < n; i++) {
+      field sum = 0;
+      for (size_t j = 1; j <= i && j < count; j++)
+        sum += a[j] * result[i - j];
+      result[i] = (0 - sum) * head;
+    }
+    return;
+  }
+
+  series_transform_size<prime>(n);
+  result.assign(1, head);
+  for (size_t m = 1; m < n; m *= 2) {
+    const size_t size = 2 * m;
+    series_transform(a, count, size, first);
+    series_transform(result.data(), m, size, second);
+    for (size_t i = 0; i < size; i++)
+      first[i] *= second[i];
+    series_inverse_transform(first.data(), size);
+    std::fill(first.begin(), first.begin() + m, 0);
+    ntt_decimation_in_frequency(first.data(), size, ntt_tables<prime>::roots(size).data());
+    for (size_t i = 0; i < size; i++)
+      first[i] *= second[i];
+    series_inverse_transform(first.data(), size);
+    result.resize(size);
+    for (size_t i = m; i < size; i++)
+      result[i] = 0 - first[i];
+  }
+  result.resize(n);
+}
+
+/**
+ * Stores first n coefficients of log a in result, for a[0] = 1.
+ * Computed as integral of a' / a.
+ */
+template <uint32 prime>
+void series_log(const prime_field<prime>* a, size_t count, size_t n,
+                std::vector<prime_field<prime>>& result) {
+  auto& workspace = series_workspace<prime>::get();
+  auto& derivative = workspace.product;
+  result.assign(n, 0);
+  if (n <= 1)
+    return;
+  series_inverse(a, count, n - 1, workspace.inverse);
+  derivative.assign(n - 1, 0);
+  for (size_t i = 1; i < std::min(count, n); i++)
+    derivative[i - 1] = a[i] * i;
+  series_multiply(derivative.data(), n - 1, workspace.inverse.data(), n - 1, n - 1, derivative.data());
+  const auto reciprocals = series_reciprocals<prime>(n);
+  for (size_t i = 1; i < n; i++)
+    result[i] = derivative[i - 1] * reciprocals[i];
+}
+
+/**
+ * Stores first n coefficients of exp a in result, for a[0] = 0.
+ * Newton iteration b' = b (1 - log b + a).
+ */
+template <uint32 prime>
+void series_exp(const prime_field<prime>* a, size_t count, size_t n,
+                std::vector<prime_field<prime>>& result) {
+  auto& logarithm = series_workspace<prime>::get().logarithm;
+  result.assign(1, 1);
+  for (size_t m = 1; m < n; m *= 2) {
+    const size_t size = 2 * m;
+    series_log(result.data(), m, size, logarithm);
+    for (size_t i = 0; i < size; i++)
+      logarithm[i] = ((i < count)? a[i] : 0) - logarithm[i];
+    logarithm[0] += 1;
+    result.resize(size);
+    series_multiply(result.data(), m, logarithm.data(), size, size, result.data());
+  }
+  result.resize(n);
+}
+
+/**
+ * Stores first n coefficients of sqrt a in result, for a[0] = 1.
+ * Newton iteration b' = (b + a / b) / 2.
+ */
+template <uint32 prime>
+void series_sqrt(const prime_field<prime>* a, size_t count, size_t n,
+                 std::vector<prime_field<prime>>& result) {
+  using field = prime_field<prime>;
+  auto& workspace = series_workspace<prime>::get();
+  const field half = inverse(field(2));
+  result.assign(1, 1);
+  for (size_t m = 1; m < n; m *= 2) {
+    const size_t size = 2 * m;
+    series_inverse(result.data(), m, size, workspace.inverse);
+    workspace.product.resize(size);
+    series_multiply(a, count, workspace.inverse.data(), size, size, workspace.product.data());
+    result.resize(size);
+    for (size_t i = 0; i < size; i++)
+      result[i] = (result[i] + workspace.product[i]) * half;
+  }
+  result.resize(n);
+}
+
+} // namespace detail
+
+/**
+ * Returns first n coefficients of formal power series 1/a,
+ * where a has coefficients in Z_prime.
+ *
+ * Throws std::invalid_argument if a is empty or a[0] = 0.
+ * Complexity is O(n log n), uses NumberTheoreticTransform,
+ * so n must not be bigger than largest power of two dividing prime - 1.
+ * Scratch memory is kept per thread and reused between calls.
+ *
+ * Example:
+ * <pre>
+ * std::vector<prime_field<kNttPrime1>> a = {1, -1};
+ * auto b = SeriesInverse(a, 4); // b = {1, 1, 1, 1}
+ * </pre>
+ */
+template <uint32 prime>
+std::vector<prime_field<prime>> SeriesInverse(const std::vector<prime_field<prime>>& a, size_t n) {
+  if (a.empty() || a[0] == 0)
+    throw std::invalid_argument("SeriesInverse - constant term must be nonzero");
+  std::vector<prime_field<prime>> result;
+  if (n > 0)
+    detail::series_inverse(a.data(), a.size(), n, result);
+  return result;
+}
+
+/**
+ * Returns first n coefficients of formal power series log a.
+ *
+ * Throws std::invalid_argument unless a[0] = 1. Complexity is O(n log n).
+ */
+template <uint32 prime>
+std::vector<prime_field<prime>> SeriesLog(const std::vector<prime_field<prime>>& a, size_t n) {
+  if (a.empty() || a[0] != 1)
+    throw std::invalid_argument("SeriesLog - constant term must be one");
+  std::vector<prime_field<prime>> result;
+  detail::series_log(a.data(), a.size(), n, result);
+  return result;
+}
+
+/**
+ * Returns first n coefficients of formal power series exp a.
+ *
+ * Throws std::invalid_argument unless a[0] = 0 (or a is empty).
+ * Complexity is O(n log n), with constant several times bigger than SeriesInverse.
+ *
+ * Example:
+ * <pre>
+ * std::vector<prime_field<kNttPrime1>> a = {0, 1};
+ * auto b = SeriesExp(a, 4); // b = {1, 1, 1/2, 1/6}
+ * </pre>
+ */
+template <uint32 prime>
+std::vector<prime_field<prime>> SeriesExp(const std::vector<prime_field<prime>>& a, size_t n) {
+  if (!a.empty() && a[0] != 0)
+    throw std::invalid_argument("SeriesExp - constant term must be zero");
+  std::vector<prime_field<prime>> result;
+  if (n > 0)
+    detail::series_exp(a.data(), a.size(), n, result);
+  return result;
+}
+
+/**
+ * Returns first n coefficients of formal power series b,
+ * such that b * b = a and b[0] = 1.
+ *
+ * Throws std::invalid_argument unless a[0] = 1. Complexity is O(n log n).
+ */
+template <uint32 prime>
+std::vector<prime_field<prime>> SeriesSqrt(const std::vector<prime_field<prime>>& a, size_t n) {
+  if (a.empty() || a[0] != 1)
+    throw std::invalid_argument("SeriesSqrt - constant term must be one");
+  std::vector<prime_field<prime>> result;
+  if (n > 0)
+    detail::series_sqrt(a.data(), a.size(), n, result);
+  return result;
+}
+
+/**
+ * Divides polynomial a by polynomial b, returns pair of quotient
+ * and remainder. Quotient has a.size() - b.size() + 1 coefficients
+ * (none if a is shorter than b), remainder always has b.size() - 1
+ * coefficients, some of them may be zeros (a shorter than b is padded).
+ *
+ * Throws std::invalid_argument if b is empty or its leading coefficient is 0.
+ * Complexity is O(n log n), quotient is computed as reversed a
+ * multiplied by inverse of reversed b.
+ *
+ * Example:
+ * <pre>
+ * std::vector<prime_field<kNttPrime1>> a = {1, 2, 1}, b = {1, 1};
+ * auto result = PolynomialDivision(a, b); // quotient = {1, 1}, remainder = {0}
+ * </pre>
+ */
+template <uint32 prime>
+std::pair<std::vector<prime_field<prime>>, std::vector<prime_field<prime>>>
+PolynomialDivision(const std::vector<prime_field<prime>>& a, const std::vector<prime_field<prime>>& b) {
+  using field = prime_field<prime>;
+  if (b.empty() || b.back() == 0)
+    throw std::invalid_argument("PolynomialDivision - leading coefficient of divisor must be nonzero");
+  if (a.size() < b.size()) {
+    std::vector<field> remainder(a.begin(), a.end());
+    remainder.resize(b.size() - 1, 0);
+    return {std::vector<field>(), remainder};
+  }
+
+  auto& workspace = detail::series_workspace<prime>::get();
+  const size_t n = a.size() - b.size() + 1;
+  auto& reversed_a = workspace.product;
+  auto& reversed_b = workspace.logarithm;
+  reversed_a.assign(a.rbegin(), a.rbegin() + n);
+  reversed_b.assign(b.rbegin(), b.rbegin() + std::min(n, b.size()));
+  detail::series_inverse(reversed_b.data(), reversed_b.size(), n, workspace.inverse);
+
+  std::vector<field> quotient(n);
+  detail::series_multiply(reversed_a.data(), n, workspace.inverse.data(), n, n, quotient.data());
+  std::reverse(quotient.begin(), quotient.end());
+
+  std::vector<field> remainder(b.size() - 1);
+  detail::series_multiply(b.data(), remainder.size(), quotient.data(), n, remainder.size(), remainder.data());
+  for (size_t i = 0; i < remainder.size(); i++)
+    remainder[i] = a[i] - remainder[i];
+  return {quotient, remainder};
+}
+
+} // namespace numeric
+} // namespace pcl
@@ -49,6 +49,25 @@ modulo(Integral value, uint32 prime) {
   return ((int64(value) % int64(prime)) + int64(prime)) % int64(prime);
 }
 
+/**
+ * Returns a + b (mod prime), for a, b smaller than prime.
+ */
+constexpr uint32 add_modulo(uint32 a, uint32 b, uint32 prime) {
+  return (uint64(a) + b >= prime)? uint32(uint64(a) + b - prime) : a + b;
+}
+
+/**
+ * Returns a - b (mod prime), for a, b smaller than prime.
+ */
+constexpr uint32 subtract_modulo(uint32 a, uint32 b, uint32 prime) {
+  return (a >= b)? a - b : uint32(uint64(a) + prime - b);
+}
+
+/**
+ * Tag of constructors taking already reduced value.
+ */
+struct reduced_tag { };
+
 } // namespace detail
 
 /**
@@ -65,15 +84,15 @@ public:
       value_(detail::modulo(value, prime)) { }
 
   friend constexpr prime_field operator+(const prime_field& lhs, const prime_field& rhs) {
-    return (uint64(lhs.value_) + uint64(rhs.value_)) % prime;
+    return prime_field(detail::add_modulo(lhs.value_, rhs.value_, prime), detail::reduced_tag());
   }
 
   friend constexpr prime_field operator-(const prime_field& lhs, const prime_field& rhs) {
-    return (uint64(prime) + uint64(lhs.value_) - uint64(rhs.value_)) % prime;
+    return prime_field(detail::subtract_modulo(lhs.value_, rhs.value_, prime), detail::reduced_tag());
   }
 
   friend constexpr prime_field operator*(const prime_field& lhs, const prime_field& rhs) {
-    return (uint64(lhs.value_) * uint64(rhs.value_)) % prime;
+    return prime_field(uint32(uint64(lhs.value_) * uint64(rhs.value_) % prime), detail::reduced_tag());
   }
 
   friend prime_field power <>(prime_field a, uint64 n);
@@ -110,6 +129,9 @@ public:
   friend std::istream& operator>> <>(std::istream& stream, prime_field& lhs);
 
 private:
+  constexpr prime_field(uint32 value, detail::reduced_tag):
+      value_(value) { }
+
   uint32 value_;
 };
 
@@ -0,0 +1,387 @@
+#pragma once
+// Jakub Staroń, 2016-2017
+
+#include "headers.h"
+#include "numeric.h"
+#include "generators.h"
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace pcl {
+namespace numeric {
+
+/**
+ * Maximal upper bound of range supported by segmented sieve.
+ *
+ * Base primes up to its square root (10^7) are kept in memory.
+ */
+constexpr uint64 kMaxSegmentedSieveLimit = 100uLL * 1000 * 1000 * 1000 * 1000;
+
+namespace detail {
+
+/**
+ * Number of 64-bit words in single segment, so that segment fits
+ * in L1 cache (32 KiB). Each bit stands for one odd number,
+ * so single segment covers 2^19 numbers.
+ */
+constexpr uint32 kSieveSegmentWords = 1u << 12;
+constexpr uint64 kSieveSegmentBits = kSieveSegmentWords * 64uLL;
+
+/**
+ * Returns odd primes p such that p * p < n.
+ *
+ * Those primes are enough to sieve any range below n.
+ */
+inline std::vector<uint32> sieve_base_primes(uint64 n) {
+  const uint64 limit = (n <= 1)? 0 : SquareFloor(n - 1) + 1;
+  std::vector<bool> composite(size_t(limit / 2 + 1), false); // i stands for 2i + 1
+  std::vector<uint32> result;
+  for (uint64 i = 1; 2 * i + 1 < limit; i++) {
+    if (composite[i])
+      continue;
+    const uint64 p = 2 * i + 1;
+    result.push_back(uint32(p));
+    for (uint64 j = p * p / 2; j < composite.size(); j += p)
+      composite[j] = true;
+  }
+  return result;
+}
+
+/**
+ * Segmented sieve of Eratosthenes over odd numbers from range [lo, hi).
+ *
+ * Range is processed segment by segment, every segment is
+ * a packed bitset of kSieveSegmentWords words, where
+ * bit i is on when begin() + 2i is prime. Number 2 is never reported.
+ */
+class segmented_sieve {
+public:
+  /**
+   * Base primes must contain all odd primes p such that p * p < hi,
+   * see sieve_base_primes. They must outlive sieve.
+   */
+  segmented_sieve(uint64 lo, uint64 hi, const std::vector<uint32>& base_primes):
+      first_(std::max<uint64>(lo, 3) | 1), bits_count_(0), segment_(0),
+      segment_bits_(0), base_primes_(base_primes), words_(kSieveSegmentWords) {
+    if (hi > first_)
+      bits_count_ = (hi - first_ + 1) / 2;
+
+    for (const uint64 p: base_primes_) {
+      if (p * p >= hi)
+        break;
+      uint64 multiple = std::max(p * p, (first_ + p - 1) / p * p);
+      if (multiple % 2 == 0)
+        multiple += p;
+      next_.push_back((multiple - first_) / 2);
+    }
+  }
+
+  segmented_sieve(const segmented_sieve&) = delete;
+  segmented_sieve& operator=(const segmented_sieve&) = delete;
+
+  /**
+   * Sieves next segment. Returns false if whole range is already processed.
+   */
+  bool next() {
+    const uint64 start = segment_ + segment_bits_;
+    if (start >= bits_count_)
+      return false;
+    segment_ = start;
+    segment_bits_ = std::min(kSieveSegmentBits, bits_count_ - segment_);
+
+    const size_t words = size_t((segment_bits_ + 63) / 64);
+    std::fill(words_.begin(), words_.begin() + words, ~uint64(0));
+    if (segment_bits_ % 64 != 0)
+      words_[words - 1] = (uint64(1) << (segment_bits_ % 64)) - 1;
+
+    uint64* bits = words_.data();
+    for (size_t k = 0; k < next_.size(); k++) {
+      const uint64 p = base_primes_[k];
+      uint64 j = next_[k] - segment_;
+      for (; j < segment_bits_; j += p)
+        bits[j / 64] &= ~(uint64(1) << (j % 64));
+      next_[k] = segment_ + j;
+    }
+    return true;
+  }
+
+  /**
+   * Returns number represented by first bit of current segment.
+   */
+  uint64 begin() const {
+    return first_ + 2 * segment_;
+  }
+
+  /**
+   * Returns number of 64-bit words used by current segment.
+   */
+  size_t size() const {
+    return size_t((segment_bits_ + 63) / 64);
+  }
+
+  /**
+   * Returns packed bitset of current segment.
+   */
+  const uint64* words() const {
+    return words_.data();
+  }
+
+  /**
+   * Calls function for every prime in current segment, in increasing order.
+   */
+  template <typename Function>
+  void for_each_prime(Function&& function) const {
+    const uint64 base = begin();
+    for (size_t i = 0; i < size(); i++) {
+      uint64 word = words_[i];
+      while (word != 0) {
+        function(base + 2 * (64 * uint64(i) + least_significant_one(word)));
+        word &= word - 1;
+      }
+    }
+  }
+
+private:
+  uint64 first_;
+  uint64 bits_count_;
+  uint64 segment_;
+  uint64 segment_bits_;
+  const std::vector<uint32>& base_primes_;
+  std::vector<uint64> next_;
+  std::vector<uint64> words_;
+};
+
+inline void check_sieve_limit(uint64 hi) {
+  if (hi > kMaxSegmentedSieveLimit)
+    throw std::invalid_argument("Sieve - range exceeds kMaxSegmentedSieveLimit");
+}
+
+/**
+ * Number of chunks per thread in parallel sieve, more chunks
+ * balance work better when threads are not equally fast.
+ */
+constexpr uint32 kSieveChunksPerThread = 8;
+
+/**
+ * Returns number of threads to use, 0 stands for all hardware threads.
+ */
+inline uint32 sieve_threads(uint32 threads) {
+  if (threads == 0)
+    threads = std::thread::hardware_concurrency();
+  return std::max<uint32>(threads, 1);
+}
+
+/**
+ * Calls function(index) for every index from range [0, chunks),
+ * using given number of threads (including calling thread).
+ *
+ * Indices are handed to threads dynamically. Exception thrown
+ * by function is rethrown, remaining indices are then skipped.
+ */
+template <typename Function>
+void parallel_chunks(size_t chunks, uint32 threads, Function function) {
+  std::atomic<size_t> next_chunk(0);
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  auto worker = [&]() {
+    try {
+      for (size_t i = next_chunk.fetch_add(1); i < chunks; i = next_chunk.fetch_add(1))
+        function(i);
+    }
+    catch (...) {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error)
+        error = std::current_exception();
+      next_chunk.store(chunks);
+    }
+  };
+
+  threads = uint32(std::min<size_t>(threads, chunks));
+  std::vector<std::thread> workers;
+  for (uint32 i = 1; i < threads; i++)
+    workers.emplace_back(worker);
+  worker();
+  for (auto& thread: workers)
+    thread.join();
+
+  if (error)
+    std::rethrow_exception(error);
+}
+
+/**
+ * Splits range [lo, hi) into chunks and calls function(index, chunk_lo, chunk_hi)
+ * for every chunk, using given number of threads.
+ *
+ * Chunks are disjoint, consist of whole segments and chunk_lo - lo
+ * is a multiple of 2^19 (segment size). Chunks are handed to threads dynamically.
+ * Returns number of chunks. Exception thrown by function is rethrown.
+ */
+template <typename Function>
+size_t parallel_sieve_chunks(uint64 lo, uint64 hi, uint32 threads, Function function) {
+  if (lo >= hi)
+    return 0;
+
+  constexpr uint64 kSegmentLength = 2 * kSieveSegmentBits;
+  const uint64 length = hi - lo;
+  const uint64 segments = (length + kSegmentLength - 1) / kSegmentLength;
+  const uint64 chunk_segments = std::max<uint64>(1, segments / (uint64(threads) * kSieveChunksPerThread));
+  const uint64 chunk_length = chunk_segments * kSegmentLength;
+  const size_t chunks = size_t((length + chunk_length - 1) / chunk_length);
+
+  parallel_chunks(chunks, threads, [&](size_t i) {
+    const uint64 chunk_lo = lo + i * chunk_length;
+    function(i, chunk_lo, std::min(hi, chunk_lo + chunk_length));
+  });
+  return chunks;
+}
+
+/**
+ * Returns primes from range [lo, hi) in increasing order,
+ * sieved in parallel. Every chunk collects its own primes,
+ * which are concatenated in order at the end.
+ */
+template <typename Integral>
+std::vector<Integral> parallel_prime_numbers(uint64 lo, uint64 hi, uint32 threads) {
+  check_sieve_limit(hi);
+  threads = sieve_threads(threads);
+  const auto base_primes = sieve_base_primes(hi);
+
+  std::vector<std::vector<Integral>> parts;
+  std::mutex parts_mutex;
+  parallel_sieve_chunks(lo, hi, threads, [&](size_t index, uint64 chunk_lo, uint64 chunk_hi) {
+    std::vector<Integral> primes;
+    if (chunk_lo <= 2 && 2 < chunk_hi)
+      primes.push_back(2);
+    segmented_sieve sieve(chunk_lo, chunk_hi, base_primes);
+    while (sieve.next())
+      sieve.for_each_prime([&primes](uint64 p) { primes.push_back(Integral(p)); });
+
+    std::lock_guard<std::mutex> lock(parts_mutex);
+    if (parts.size() <= index)
+      parts.resize(index + 1);
+    parts[index] = std::move(primes);
+  });
+
+  size_t count = 0;
+  for (const auto& part: parts)
+    count += part.size();
+  std::vector<Integral> result;
+  result.reserve(count);
+  for (const auto& part: parts)
+    result.insert(result.end(), part.begin(), part.end());
+  return result;
+}
+
+} // namespace detail
+
+/**
+ * Calls function for every prime from range [lo, hi), in increasing order.
+ *
+ * Uses segmented sieve of Eratosthenes, memory usage is
+ * O(sqrt(hi) + segment size) regardless of size of range.
+ * Throws std::invalid_argument if hi exceeds kMaxSegmentedSieveLimit.
+ *
+ * Example:
+ * <pre>
+ * uint64 sum = 0;
+ * ForEachPrime(1000uLL * 1000 * 1000 * 1000, 1000uLL * 1000 * 1000 * 1000 + 1000,
+ *              [&](uint64 p) { sum += p; });
+ * </pre>
+ */
+template <typename Function>
+void ForEachPrime(uint64 lo, uint64 hi, Function function) {
+  detail::check_sieve_limit(hi);
+  if (lo <= 2 && 2 < hi)
+    function(uint64(2));
+
+  const auto base_primes = detail::sieve_base_primes(hi);
+  detail::segmented_sieve sieve(lo, hi, base_primes);
+  while (sieve.next())
+    sieve.for_each_prime(function);
+}
+
+/**
+ * Returns vector of primes from range [lo, hi) in increasing order.
+ *
+ * Range is sieved by given number of threads, 0 stands
+ * for std::thread::hardware_concurrency(). Each thread sieves
+ * disjoint segments and results are merged in order.
+ *
+ * Example:
+ * <pre>
+ * auto primes = CollectPrimes(0, 10uLL * 1000 * 1000 * 1000, 0); // all cores
+ * </pre>
+ */
+std::vector<uint64> CollectPrimes(uint64 lo, uint64 hi, uint32 threads = 1) {
+  return detail::parallel_prime_numbers<uint64>(lo, hi, threads);
+}
+
+/**
+ * Returns number of primes in range [lo, hi).
+ *
+ * Range is sieved by given number of threads, see CollectPrimes.
+ */
+uint64 CountPrimes(uint64 lo, uint64 hi, uint32 threads = 1) {
+  detail::check_sieve_limit(hi);
+  threads = detail::sieve_threads(threads);
+  const auto base_primes = detail::sieve_base_primes(hi);
+  std::atomic<uint64> count((lo <= 2 && 2 < hi)? 1 : 0);
+  detail::parallel_sieve_chunks(lo, hi, threads, [&](size_t, uint64 chunk_lo, uint64 chunk_hi) {
+    uint64 chunk_count = 0;
+    detail::segmented_sieve sieve(chunk_lo, chunk_hi, base_primes);
+    while (sieve.next())
+      for (size_t i = 0; i < sieve.size(); i++)
+        chunk_count += pop_count(sieve.words()[i]);
+    count.fetch_add(chunk_count);
+  });
+  return count;
+}
+
+/**
+ * Returns generator yielding primes from range [lo, hi) in increasing order.
+ *
+ * Primes are sieved lazily segment by segment, see ForEachPrime.
+ */
+Generator<uint64> PrimesInRange(uint64 lo, uint64 hi) {
+  class PrimesGenerator: public GeneratorBase<uint64> {
+  public:
+    PrimesGenerator(uint64 lo, uint64 hi):
+        two_(lo <= 2 && 2 < hi), base_primes_(detail::sieve_base_primes(hi)),
+        sieve_(lo, hi, base_primes_), index_(0), word_(0) { }
+
+    Maybe<uint64> next() final {
+      if (two_) {
+        two_ = false;
+        return uint64(2);
+      }
+      while (word_ == 0) {
+        index_++;
+        if (index_ >= sieve_.size()) {
+          if (!sieve_.next())
+            return Nothing;
+          index_ = 0;
+        }
+        word_ = sieve_.words()[index_];
+      }
+      const uint64 result = sieve_.begin() + 2 * (64 * uint64(index_) + least_significant_one(word_));
+      word_ &= word_ - 1;
+      return result;
+    }
+
+  private:
+    bool two_;
+    std::vector<uint32> base_primes_;
+    detail::segmented_sieve sieve_;
+    size_t index_;
+    uint64 word_;
+  };
+
+  detail::check_sieve_limit(hi);
+  return pcl::detail::build_generator<PrimesGenerator>(lo, hi);
+}
+
+} // namespace numeric
+} // namespace pcl
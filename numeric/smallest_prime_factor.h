@@ -0,0 +1,183 @@
+#pragma once
+// Jakub Staroń, 2016-2017
+
+#include "headers.h"
+
+namespace pcl {
+namespace numeric {
+
+/**
+ * Table of smallest prime factors of numbers smaller than given bound.
+ *
+ * Table is built by linear sieve in O(n) time. Only odd numbers
+ * are stored, on 16 bits each: smallest prime factor of odd composite
+ * below 2^32 is smaller than 2^16, while primes are marked with 0.
+ * Table for 10^8 takes 100 MB.
+ *
+ * Factorization of any number below bound takes O(number of prime factors).
+ *
+ * Example:
+ * <pre>
+ * SmallestPrimeFactorTable table(100 * 1000 * 1000);
+ * auto factors = table.factorize(360); // 2, 2, 2, 3, 3, 5
+ * </pre>
+ */
+class SmallestPrimeFactorTable {
+public:
+  static constexpr uint32 kMaxFactors = 32; /// Bound of number of prime factors of uint32
+
+  /**
+   * Builds table for numbers from range [0, n).
+   */
+  explicit SmallestPrimeFactorTable(uint32 n):
+      size_(n), factors_(n / 2 + 1, 0) {
+    std::vector<uint16> primes; // odd primes smaller than sqrt(n)
+    for (uint64 i = 3; i < n; i += 2) {
+      uint32 smallest = factors_[i / 2];
+      if (smallest == 0) {
+        smallest = uint32(i);
+        if (i * i < n)
+          primes.push_back(uint16(i));
+      }
+      for (const uint64 p: primes) {
+        if (p > smallest || p * i >= n)
+          break;
+        factors_[p * i / 2] = uint16(p);
+      }
+    }
+  }
+
+  /**
+   * Returns bound of table, ie table contains numbers smaller than size().
+   */
+  uint32 size() const {
+    return size_;
+  }
+
+  /**
+   * Returns true if n is covered by table.
+   */
+  bool contains(uint64 n) const {
+    return n < size_;
+  }
+
+  /**
+   * Returns smallest prime factor of n.
+   *
+   * Throws std::out_of_range if n is not covered by table
+   * and std::invalid_argument if n < 2.
+   */
+  uint32 smallestPrimeFactor(uint32 n) const {
+    check(n);
+    return factor(n);
+  }
+
+  /**
+   * Returns true if n is prime.
+   *
+   * Throws std::out_of_range if n is not covered by table.
+   */
+  bool isPrime(uint32 n) const {
+    if (!contains(n))
+      throw std::out_of_range("SmallestPrimeFactorTable - number out of range");
+    return n >= 2 && factor(n) == n;
+  }
+
+  /**
+   * Returns prime factors of n in increasing order,
+   * with multiplicities (like Factorize).
+   *
+   * Throws std::out_of_range if n is not covered by table.
+   */
+  std::vector<uint32> factorize(uint32 n) const {
+    std::vector<uint32> result;
+    factorize(n, result);
+    return result;
+  }
+
+  /**
+   * Stores prime factors of n in given vector, replacing its content.
+   *
+   * Reusing the same vector avoids memory allocation per call,
+   * which dominates cost of factorization in batch jobs.
+   */
+  void factorize(uint32 n, std::vector<uint32>& result) const {
+    if (!contains(n))
+      throw std::out_of_range("SmallestPrimeFactorTable - number out of range");
+    if (n == 0)
+      throw std::invalid_argument("SmallestPrimeFactorTable - cannot factorize 0");
+    result.clear();
+    result.reserve(kMaxFactors);
+    while (n > 1) {
+      const uint32 p = factor(n);
+      result.push_back(p);
+      n /= p;
+    }
+  }
+
+private:
+  void check(uint32 n) const {
+    if (!contains(n))
+      throw std::out_of_range("SmallestPrimeFactorTable - number out of range");
+    if (n < 2)
+      throw std::invalid_argument("SmallestPrimeFactorTable - number has no prime factors");
+  }
+
+  uint32 factor(uint32 n) const {
+    if (n % 2 == 0)
+      return 2;
+    const uint32 smallest = factors_[n / 2];
+    return (smallest == 0)? n : smallest;
+  }
+
+  uint32 size_;
+  std::vector<uint16> factors_;
+};
+
+constexpr uint32 SmallestPrimeFactorTable::kMaxFactors;
+
+namespace detail {
+
+inline std::unique_ptr<SmallestPrimeFactorTable>& global_smallest_prime_factor_table() {
+  static std::unique_ptr<SmallestPrimeFactorTable> table;
+  return table;
+}
+
+} // namespace detail
+
+/**
+ * Builds global table of smallest prime factors of numbers smaller than n.
+ *
+ * Once built, Factorize, PrimeDivisors, Divisors and MultiplicativeOrder
+ * use it for arguments covered by table. Table should be built
+ * before other threads use those functions.
+ *
+ * Example:
+ * <pre>
+ * BuildSmallestPrimeFactorTable(100 * 1000 * 1000);
+ * for (uint32 n: numbers)
+ *   print("%0", Factorize(n)); // O(log n) each
+ * </pre>
+ */
+const SmallestPrimeFactorTable& BuildSmallestPrimeFactorTable(uint32 n) {
+  auto& table = detail::global_smallest_prime_factor_table();
+  table.reset(new SmallestPrimeFactorTable(n));
+  return *table;
+}
+
+/**
+ * Releases global table of smallest prime factors, if any.
+ */
+void ReleaseSmallestPrimeFactorTable() {
+  detail::global_smallest_prime_factor_table().reset();
+}
+
+/**
+ * Returns global table of smallest prime factors or nullptr if it is not built.
+ */
+const SmallestPrimeFactorTable* GlobalSmallestPrimeFactorTable() {
+  return detail::global_smallest_prime_factor_table().get();
+}
+
+} // namespace numeric
+} // namespace pcl
@@ -0,0 +1,208 @@
+// Jakub Staroń, 2016-2017
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include "iterators.h"
+#include "io/fast_reader.h"
+#include "io/fast_writer.h"
+#include "numeric/big_unsigned.h"
+#include "numeric/number_theory.h"
+
+using namespace pcl;
+using namespace pcl::numeric;
+
+namespace {
+
+BigUnsigned random_number(size_t limbs) {
+  BigUnsigned result = 0;
+  for (auto i: range<size_t>(0, limbs))
+    result = result * BigUnsigned(1uLL << 32) + BigUnsigned(Random32());
+  return result;
+}
+
+BigUnsigned schoolbook_product(const BigUnsigned& a, const BigUnsigned& b) {
+  std::vector<uint32> limbs(a.limbs().size() + b.limbs().size());
+  numeric::detail::schoolbook_multiply(a.limbs().data(), a.limbs().size(), b.limbs().data(), b.limbs().size(),
+                                       limbs.data());
+  BigUnsigned result = 0;
+  for (size_t i = limbs.size(); i-- > 0; )
+    result = result * BigUnsigned(1uLL << 32) + BigUnsigned(limbs[i]);
+  return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(big_unsigned_suite)
+
+BOOST_AUTO_TEST_CASE(conversion_test) {
+  BOOST_CHECK(BigUnsigned().isZero());
+  BOOST_CHECK(BigUnsigned(0).limbs().empty());
+  BOOST_CHECK_EQUAL(BigUnsigned(0).toString(), "0");
+  BOOST_CHECK_EQUAL(BigUnsigned(~0uLL).toString(), "18446744073709551615");
+  BOOST_CHECK_EQUAL(BigUnsigned(~0uLL).toUint64(), ~0uLL);
+  BOOST_CHECK_EQUAL(BigUnsigned(~0uLL).bitLength(), 64);
+  BOOST_CHECK_EQUAL(BigUnsigned(1).bitLength(), 1);
+  BOOST_CHECK_EQUAL(BigUnsigned(0).bitLength(), 0);
+
+  const std::string power = "340282366920938463463374607431768211456"; // 2^128
+  BOOST_CHECK_EQUAL(BigUnsigned(power).toString(), power);
+  BOOST_CHECK_EQUAL(BigUnsigned(power).bitLength(), 129);
+  BOOST_CHECK(BigUnsigned(power) == BigUnsigned(1uLL << 32) * BigUnsigned(1uLL << 32) *
+                                    BigUnsigned(1uLL << 32) * BigUnsigned(1uLL << 32));
+  BOOST_CHECK_THROW(BigUnsigned(power).toUint64(), std::out_of_range);
+  BOOST_CHECK_EQUAL(BigUnsigned("000000000000000000123").toString(), "123");
+  BOOST_CHECK_EQUAL(BigUnsigned("1000000000").toString(), "1000000000");
+  BOOST_CHECK_THROW(BigUnsigned(""), std::invalid_argument);
+  BOOST_CHECK_THROW(BigUnsigned("12a"), std::invalid_argument);
+  BOOST_CHECK_THROW(BigUnsigned("-1"), std::invalid_argument);
+
+  for (auto i: range<uint32>(0, 100)) {
+    const auto number = random_number(i);
+    BOOST_CHECK(BigUnsigned(number.toString()) == number);
+  }
+
+  // Big numbers are converted by divide and conquer.
+  for (auto size: {65u, 128u, 129u, 500u, 1000u, 2500u}) {
+    const auto number = random_number(size);
+    std::vector<uint32> chunks;
+    for (auto rest = number; !rest.isZero(); )
+      chunks.push_back(rest.divide(1000 * 1000 * 1000));
+    BOOST_CHECK(number.decimalChunks() == chunks);
+    BOOST_CHECK(BigUnsigned(number.toString()) == number);
+  }
+  for (auto digits: {600u, 1153u, 4609u, 20000u}) {
+    const std::string power = "1" + std::string(digits, '0');
+    const std::string nines(digits, '9');
+    BOOST_CHECK(BigUnsigned(power) - BigUnsigned(1) == BigUnsigned(nines));
+    BOOST_CHECK_EQUAL(BigUnsigned(power).toString(), power);
+    BOOST_CHECK_EQUAL(BigUnsigned(nines).toString(), nines);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(arithmetic_test) {
+  for (auto i: range<uint32>(0, 1000)) {
+    const uint64 a = Random32(), b = Random32();
+    BOOST_CHECK_EQUAL((BigUnsigned(a) * BigUnsigned(b)).toUint64(), a * b);
+    BOOST_CHECK_EQUAL((BigUnsigned(a << 31) + BigUnsigned(b << 31)).toUint64(), (a << 31) + (b << 31));
+    BOOST_CHECK_EQUAL((BigUnsigned(a + b) - BigUnsigned(b)).toUint64(), a);
+    BOOST_CHECK_EQUAL(BigUnsigned(a) < BigUnsigned(b), a < b);
+    BOOST_CHECK_EQUAL(compare(BigUnsigned(a), BigUnsigned(b)), (a < b)? -1 : (a > b)? 1 : 0);
+  }
+  BOOST_CHECK_THROW(BigUnsigned(1) - BigUnsigned(2), std::invalid_argument);
+  BOOST_CHECK(BigUnsigned(~0uLL) + BigUnsigned(1) == BigUnsigned("18446744073709551616"));
+  BOOST_CHECK(BigUnsigned("18446744073709551616") - BigUnsigned(1) == BigUnsigned(~0uLL));
+
+  BigUnsigned factorial = 1;
+  for (uint32 i = 2; i <= 30; i++)
+    factorial *= i;
+  BOOST_CHECK_EQUAL(factorial.toString(), "265252859812191058636308480000000");
+
+  for (auto i: range<uint32>(0, 50)) {
+    const auto a = random_number(Random32() % 50), b = random_number(Random32() % 50);
+    BOOST_CHECK((a + b) - b == a);
+    BOOST_CHECK((a + b) - a == b);
+    BOOST_CHECK(a + b > a || b.isZero());
+    BOOST_CHECK(a * b == b * a);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(karatsuba_test) {
+  for (auto sizes: std::vector<std::pair<size_t, size_t>>{{64, 64}, {65, 130}, {200, 199}, {257, 300}, {63, 700},
+                                                           {1000, 1001}, {64, 129}}) {
+    const auto a = random_number(sizes.first), b = random_number(sizes.second);
+    BOOST_CHECK(a * b == schoolbook_product(a, b));
+    BOOST_CHECK(a * (b + BigUnsigned(1)) == a * b + a);
+  }
+
+  // All limbs set maximize carries.
+  const auto ones = BigUnsigned(1) + BigUnsigned(~0uLL) * BigUnsigned(~0uLL) * BigUnsigned(~0uLL);
+  auto big = ones;
+  for (auto i: range<uint32>(0, 7))
+    big = big * big + big;
+  BOOST_CHECK(big * big == schoolbook_product(big, big));
+}
+
+BOOST_AUTO_TEST_CASE(division_test) {
+  for (auto i: range<uint32>(0, 100)) {
+    const auto a = random_number(Random32() % 40);
+    const uint32 divisor = Random32() % 1000000 + 1;
+    const uint32 remainder = Random32() % divisor;
+    const auto number = a * BigUnsigned(divisor) + BigUnsigned(remainder);
+    BOOST_CHECK(number / divisor == a);
+    BOOST_CHECK_EQUAL(number % divisor, remainder);
+
+    auto copy = number;
+    BOOST_CHECK_EQUAL(copy.divide(divisor), remainder);
+    BOOST_CHECK(copy == a);
+
+    const uint64 big_divisor = Random64() | (1uLL << 63);
+    const uint64 big_remainder = Random64() % big_divisor;
+    BOOST_CHECK_EQUAL((a * BigUnsigned(big_divisor) + BigUnsigned(big_remainder)) % big_divisor, big_remainder);
+  }
+  BOOST_CHECK_EQUAL(BigUnsigned(~0uLL) % 10, 5);
+  BOOST_CHECK_THROW(BigUnsigned(1) / 0, std::invalid_argument);
+  BOOST_CHECK_THROW(BigUnsigned(1) % 0, std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(input_output_test) {
+  const auto number = random_number(40);
+  std::stringstream stream;
+  stream << number << ' ' << BigUnsigned(0) << " 12x";
+  BigUnsigned a, b, c;
+  stream >> a >> b;
+  BOOST_CHECK(bool(stream));
+  BOOST_CHECK(a == number);
+  BOOST_CHECK(b.isZero());
+  stream >> c;
+  BOOST_CHECK(!stream);
+
+  std::ostringstream output;
+  {
+    FastWriter writer(output);
+    writer << number << ' ' << BigUnsigned(0) << ' ' << BigUnsigned("1000000000000000000000001");
+  }
+  BOOST_CHECK_EQUAL(output.str(), number.toString() + " 0 1000000000000000000000001");
+
+  const std::string text = output.str() + " -5";
+  FastReader reader(text.data(), text.data() + text.size());
+  reader >> a >> b >> c;
+  BOOST_CHECK(bool(reader));
+  BOOST_CHECK(a == number);
+  BOOST_CHECK(b.isZero());
+  BOOST_CHECK_EQUAL(c.toString(), "1000000000000000000000001");
+  reader >> a;
+  BOOST_CHECK(!reader);
+}
+
+BOOST_AUTO_TEST_CASE(chinese_remainder_test) {
+  std::vector<uint64_pair> congruences;
+  BigUnsigned product = 1;
+  for (auto p: PrimeNumbers(10000)) {
+    if (p > 9000) {
+      congruences.emplace_back(Random32() % p, p);
+      product *= p;
+    }
+  }
+  congruences.emplace_back(Random64() % 0xFFFFFFFFFFFFFFC5uLL, 0xFFFFFFFFFFFFFFC5uLL);
+  product *= 0xFFFFFFFFFFFFFFC5uLL;
+
+  const auto result = ChineseRemainder(congruences.begin(), congruences.end());
+  BOOST_CHECK(result.second == product);
+  BOOST_CHECK(result.first < product);
+  for (const auto& congruence: congruences)
+    BOOST_CHECK_EQUAL(result.first % congruence.second, congruence.first);
+
+  // Not coprime moduli, same as MergeCongruences
+  std::vector<uint64_pair> small = {{2, 4}, {4, 6}, {1, 5}};
+  const auto merged = MergeCongruences(small.begin(), small.end());
+  const auto big = ChineseRemainder(small.begin(), small.end());
+  BOOST_CHECK_EQUAL(big.first.toUint64(), merged.first);
+  BOOST_CHECK_EQUAL(big.second.toUint64(), merged.second);
+
+  std::vector<uint64_pair> contradicting = {{1, 2}, {2, 4}};
+  BOOST_CHECK_THROW(ChineseRemainder(contradicting.begin(), contradicting.end()), std::runtime_error);
+  BOOST_CHECK_THROW(MergeCongruences(uint64_pair(1, 4294967291), uint64_pair(2, 8589934583)), std::overflow_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,138 @@
+// Jakub Staroń, 2016-2017
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include "numeric.h"
+#include "numeric/dynamic_field.h"
+#include "numeric/number_theory.h"
+#include "io.h"
+
+using namespace pcl;
+
+namespace {
+
+struct small_modulus;
+struct big_modulus;
+using small_field = numeric::dynamic_field<small_modulus>;
+using big_field = numeric::dynamic_field<big_modulus>;
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(dynamic_field_suite)
+
+BOOST_AUTO_TEST_CASE(barrett_test) {
+  for (uint32 modulus: {1u, 2u, 3u, 7u, 1000000007u, 1u << 31, uint32_prime1, ~0u}) {
+    numeric::Barrett32 context(modulus);
+    BOOST_CHECK_EQUAL(context.modulus(), modulus);
+    for (uint64 a: std::initializer_list<uint64>{0, 1, uint64(modulus) - 1, modulus, ~0uLL, ~0uLL - 1})
+      BOOST_CHECK_EQUAL(context.reduce(a), a % modulus);
+    for (auto i: range<uint32>(0, 1000)) {
+      const uint64 a = Random64();
+      BOOST_CHECK_EQUAL(context.reduce(a), a % modulus);
+      const uint32 x = uint32(Random32() % modulus), y = uint32(Random32() % modulus);
+      BOOST_CHECK_EQUAL(context.multiply(x, y), uint64(x) * y % modulus);
+      BOOST_CHECK_EQUAL(context.add(x, y), (uint64(x) + y) % modulus);
+      BOOST_CHECK_EQUAL(context.subtract(x, y), (uint64(x) + modulus - y) % modulus);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(creation_test) {
+  small_field::setModulus(5);
+  BOOST_CHECK_EQUAL(small_field::modulus(), 5);
+  BOOST_CHECK_EQUAL(small_field(10).value(), 0);
+  BOOST_CHECK_EQUAL(small_field(4), small_field(-1));
+  BOOST_CHECK_EQUAL(small_field((1uLL << 63) + uint64(1000 * 1000 * 1000)).value(), 3);
+  BOOST_CHECK_EQUAL(small_field(-((1LL << 62) + 1000 * 1000 * 1000)).value(), 1);
+  BOOST_CHECK_EQUAL(small_field(std::numeric_limits<int64>::min()).value(), 2);
+  BOOST_CHECK_THROW(small_field::setModulus(0), std::invalid_argument);
+
+  big_field::setModulus(uint32_prime1);
+  BOOST_CHECK_EQUAL(big_field(uint64(uint32_prime1) * uint32_prime1 + 100).value(), 100);
+  BOOST_CHECK_EQUAL(big_field(-int64(uint32_prime1) - int64(uint32_prime1) - 10), -10);
+  BOOST_CHECK_EQUAL(small_field::modulus(), 5);
+}
+
+BOOST_AUTO_TEST_CASE(arithmetic_test) {
+  small_field::setModulus(5);
+  small_field a(2), b(3);
+  BOOST_CHECK_EQUAL(a + b, 0);
+  BOOST_CHECK_EQUAL(a - b, 4);
+  BOOST_CHECK_EQUAL(b * b * b, 2);
+  BOOST_CHECK_EQUAL(1 + a * 3, 2);
+  BOOST_CHECK_EQUAL(a / 3, 4);
+  a += b;
+  BOOST_CHECK_EQUAL(a, 0);
+  a -= b;
+  BOOST_CHECK_EQUAL(a, 2);
+  a *= b;
+  BOOST_CHECK_EQUAL(a, 1);
+  a /= b;
+  BOOST_CHECK_EQUAL(a, 2);
+  BOOST_CHECK(a != b);
+
+  big_field::setModulus(uint32_prime1);
+  big_field c(uint32_prime1 - 1), d(uint32_prime1 - 2);
+  BOOST_CHECK_EQUAL(c * d, 2);
+  BOOST_CHECK_EQUAL(c + d + 3, 0);
+  BOOST_CHECK_EQUAL(d / c, 2);
+  BOOST_CHECK_EQUAL(inverse(big_field(123456)), 1336367439u);
+  BOOST_CHECK_EQUAL(power(big_field(2), uint32_prime1 - 1), 1);
+
+  big_field::setModulus(1000000007);
+  for (auto i: range<uint32>(0, 1000)) {
+    const uint32 x = Random32(), y = Random32();
+    BOOST_CHECK_EQUAL((big_field(x) * big_field(y)).value(), uint64(x) * y % 1000000007);
+    BOOST_CHECK_EQUAL((big_field(x) - big_field(y)).value(),
+                      numeric::Subtract64(x, y, 1000000007));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(composite_modulus_test) {
+  small_field::setModulus(12);
+  BOOST_CHECK_EQUAL(inverse(small_field(5)), 5);
+  BOOST_CHECK_EQUAL(small_field(7) / small_field(11), 5);
+  BOOST_CHECK_THROW(inverse(small_field(4)), std::runtime_error);
+  BOOST_CHECK_THROW(inverse(small_field(0)), std::runtime_error);
+  BOOST_CHECK_EQUAL(power(small_field(2), 10), 4);
+  BOOST_CHECK_EQUAL(power(small_field(7), 0), 1);
+}
+
+BOOST_AUTO_TEST_CASE(thread_local_modulus_test) {
+  small_field::setModulus(7);
+  uint32 other = 0;
+  std::thread thread([&other]() {
+    small_field::setModulus(11);
+    other = (small_field(10) * small_field(10)).value();
+  });
+  thread.join();
+  BOOST_CHECK_EQUAL(other, 1);
+  BOOST_CHECK_EQUAL(small_field::modulus(), 7);
+  BOOST_CHECK_EQUAL(small_field(10) * small_field(10), 2);
+}
+
+BOOST_AUTO_TEST_CASE(io_test) {
+  small_field::setModulus(5);
+  {
+    std::ostringstream stream;
+    stream << small_field(9);
+    BOOST_CHECK_EQUAL(stream.str(), "4");
+  }
+
+  {
+    std::istringstream stream("1234 -1");
+    small_field a, b;
+    stream >> a >> b;
+    BOOST_CHECK_EQUAL(a, 4);
+    BOOST_CHECK_EQUAL(b, 4);
+  }
+
+  {
+    std::ostringstream stream;
+    print(stream, "%0 %1", small_field(7), small_field(-7));
+    BOOST_CHECK_EQUAL(stream.str(), "2 3\n");
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
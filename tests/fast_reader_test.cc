@@ -0,0 +1,263 @@
+// Jakub Staroń, 2016-2017
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include "io/fast_reader.h"
+
+using namespace pcl;
+
+BOOST_AUTO_TEST_SUITE(fast_reader_suite)
+
+struct MemoryReader {
+  explicit MemoryReader(std::string text):
+      text_(std::move(text)), reader(text_.data(), text_.data() + text_.size()) { }
+
+  std::string text_;
+  FastReader reader;
+};
+
+BOOST_AUTO_TEST_CASE(integers_test) {
+  {
+    MemoryReader input("1 -2\n+3\t\t4000000000 -9223372036854775808");
+    int a, b, c;
+    uint32 d;
+    int64 e;
+    input.reader >> a >> b >> c >> d >> e;
+    BOOST_CHECK(bool(input.reader));
+    BOOST_CHECK_EQUAL(a, 1);
+    BOOST_CHECK_EQUAL(b, -2);
+    BOOST_CHECK_EQUAL(c, 3);
+    BOOST_CHECK_EQUAL(d, 4000000000u);
+    BOOST_CHECK_EQUAL(e, std::numeric_limits<int64>::min());
+    BOOST_CHECK(input.reader.eof());
+  }
+
+  {
+    MemoryReader input("18446744073709551615");
+    uint64 n;
+    input.reader >> n;
+    BOOST_CHECK_EQUAL(n, std::numeric_limits<uint64>::max());
+  }
+
+  {
+    MemoryReader input("32767 -32768 -2147483648 000000000000000000000018446744073709551615");
+    int16 a, b;
+    int32 c;
+    uint64 d;
+    input.reader >> a >> b >> c >> d;
+    BOOST_CHECK(bool(input.reader));
+    BOOST_CHECK_EQUAL(a, 32767);
+    BOOST_CHECK_EQUAL(b, -32768);
+    BOOST_CHECK_EQUAL(c, std::numeric_limits<int32>::min());
+    BOOST_CHECK_EQUAL(d, std::numeric_limits<uint64>::max());
+  }
+
+  // Values out of range of the type fail instead of wrapping.
+  for (auto text: {"32768", "-32769", "2147483648", "-2147483649", "18446744073709551616", "99999999999999999999"}) {
+    MemoryReader input(text);
+    int16 a = 1;
+    input.reader >> a;
+    BOOST_CHECK(!input.reader);
+    BOOST_CHECK_EQUAL(a, 1);
+  }
+  for (auto text: {"2147483648", "-2147483649", "18446744073709551616"}) {
+    MemoryReader input(text);
+    int32 a = 1;
+    input.reader >> a;
+    BOOST_CHECK(!input.reader);
+    BOOST_CHECK_EQUAL(a, 1);
+  }
+  for (auto text: {"9223372036854775808", "-9223372036854775809", "00000000000000000000018446744073709551616"}) {
+    MemoryReader input(text);
+    int64 a = 1;
+    input.reader >> a;
+    BOOST_CHECK(!input.reader);
+    BOOST_CHECK_EQUAL(a, 1);
+  }
+  {
+    MemoryReader input("18446744073709551616");
+    uint64 a = 1;
+    input.reader >> a;
+    BOOST_CHECK(!input.reader);
+    BOOST_CHECK_EQUAL(a, 1);
+  }
+
+  {
+    MemoryReader input("  ");
+    int n;
+    input.reader >> n;
+    BOOST_CHECK(!input.reader);
+  }
+
+  {
+    MemoryReader input("Ala");
+    int n;
+    input.reader >> n;
+    BOOST_CHECK(!input.reader);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(floating_test) {
+  MemoryReader input("1.5 -0.25 3 1e3 2.5E-2 0.1 123456789012345678901234567890 1e-400 x");
+  double a, b, c, d, e, f, g, h, i;
+  float j = 0;
+  input.reader >> a >> b >> c >> d >> e >> f >> g >> h;
+  BOOST_CHECK(bool(input.reader));
+  BOOST_CHECK_EQUAL(a, 1.5);
+  BOOST_CHECK_EQUAL(b, -0.25);
+  BOOST_CHECK_EQUAL(c, 3.0);
+  BOOST_CHECK_EQUAL(d, 1000.0);
+  BOOST_CHECK_EQUAL(e, 0.025);
+  BOOST_CHECK_EQUAL(f, 0.1);
+  BOOST_CHECK_EQUAL(g, 123456789012345678901234567890.0);
+  BOOST_CHECK_EQUAL(h, 0.0);
+  input.reader >> i;
+  BOOST_CHECK(!input.reader);
+
+  MemoryReader second("0.5");
+  second.reader >> j;
+  BOOST_CHECK_EQUAL(j, 0.5f);
+
+  // Tokens longer than kMaxNumberLength are consumed as a whole.
+  const std::string zeros(FastReader::kMaxNumberLength + 50, '0');
+  MemoryReader third(zeros + "25 " + zeros + "3.5 7");
+  double k, l, m;
+  third.reader >> k >> l >> m;
+  BOOST_CHECK(bool(third.reader));
+  BOOST_CHECK_EQUAL(k, 25.0);
+  BOOST_CHECK_EQUAL(l, 3.5);
+  BOOST_CHECK_EQUAL(m, 7.0);
+
+  MemoryReader fourth("x" + zeros);
+  fourth.reader >> k;
+  BOOST_CHECK(!fourth.reader);
+  BOOST_CHECK(fourth.reader.eof());
+}
+
+BOOST_AUTO_TEST_CASE(strings_test) {
+  {
+    MemoryReader input(" Ala  ma\nkota\n");
+    std::string a, b, c, d;
+    input.reader >> a >> b >> c;
+    BOOST_CHECK_EQUAL(a, "Ala");
+    BOOST_CHECK_EQUAL(b, "ma");
+    BOOST_CHECK_EQUAL(c, "kota");
+    BOOST_CHECK(bool(input.reader));
+    input.reader >> d;
+    BOOST_CHECK(!input.reader);
+  }
+
+  {
+    MemoryReader input("a b\tc");
+    char a, b, c;
+    input.reader >> a >> b >> c;
+    BOOST_CHECK_EQUAL(a, 'a');
+    BOOST_CHECK_EQUAL(b, 'b');
+    BOOST_CHECK_EQUAL(c, 'c');
+  }
+
+  {
+    MemoryReader input("Ala ma\n\nkota");
+    std::string line;
+    std::vector<std::string> result;
+    while (input.reader.getline(line))
+      result.push_back(line);
+    std::vector<std::string> expected = {"Ala ma", "", "kota"};
+    BOOST_CHECK(result == expected);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(read_test) {
+  {
+    MemoryReader input("1 2 3");
+    int a, b;
+    read(input.reader, a, ignore<int>(), b);
+    BOOST_CHECK_EQUAL(a, 1);
+    BOOST_CHECK_EQUAL(b, 3);
+  }
+
+  {
+    MemoryReader input("Ala 1 2 3 4");
+    std::tuple<std::string, int, int> tuple;
+    std::pair<int, int> pair;
+    read(input.reader, tuple, pair);
+    BOOST_CHECK(tuple == std::make_tuple(std::string("Ala"), 1, 2));
+    BOOST_CHECK(pair == std::make_pair(3, 4));
+  }
+
+  {
+    MemoryReader input("1 2 3");
+    int a, b, c;
+    input.reader >> std::tie(a, b, c);
+    BOOST_CHECK_EQUAL(a, 1);
+    BOOST_CHECK_EQUAL(b, 2);
+    BOOST_CHECK_EQUAL(c, 3);
+  }
+
+  {
+    MemoryReader input("1234 -1");
+    numeric::prime_field<5> a, b;
+    input.reader >> a >> b;
+    BOOST_CHECK_EQUAL(a, 4);
+    BOOST_CHECK_EQUAL(b, 4);
+  }
+
+  {
+    MemoryReader input("1234 -1");
+    numeric::dynamic_field<>::setModulus(7);
+    numeric::dynamic_field<> a, b;
+    input.reader >> a >> b;
+    BOOST_CHECK_EQUAL(a, 2);
+    BOOST_CHECK_EQUAL(b, 6);
+  }
+
+  {
+    MemoryReader input("1 2 3 4");
+    auto v = as_vector(ReadSequence<uint32_pair>(input.reader, 2));
+    std::vector<uint32_pair> expected = {{1, 2}, {3, 4}};
+    BOOST_CHECK(v == expected);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(bulk_read_test) {
+  MemoryReader input("1 2 3 4 5 6 7 8 9 10");
+  std::vector<int> v;
+  ReadInto(input.reader, v, 4);
+  std::vector<int> expected = {1, 2, 3, 4};
+  BOOST_CHECK(v == expected);
+
+  auto columns = ReadColumns<std::tuple<int, uint64, int>>(input.reader, 2);
+  BOOST_CHECK(std::get<0>(columns) == std::vector<int>({5, 8}));
+  BOOST_CHECK(std::get<1>(columns) == std::vector<uint64>({6, 9}));
+  BOOST_CHECK(std::get<2>(columns) == std::vector<int>({7, 10}));
+}
+
+BOOST_AUTO_TEST_CASE(file_test) {
+  // Input bigger than buffer, so tokens cross buffer boundaries.
+  constexpr uint32 count = 100 * 1000;
+  std::FILE* file = std::tmpfile();
+  BOOST_REQUIRE(file != nullptr);
+  std::string text;
+  for (auto i: range<uint32>(0, count)) {
+    text += std::to_string(i * 7919u);
+    text += (i % 2 == 0)? ' ' : '\n';
+  }
+  text += "Ala";
+  std::fwrite(text.data(), 1, text.size(), file);
+  std::rewind(file);
+
+  FastReader reader(file);
+  auto v = as_vector(ReadSequence<uint32>(reader, count));
+  std::string last;
+  reader >> last;
+  BOOST_CHECK(bool(reader));
+  BOOST_CHECK_EQUAL(last, "Ala");
+  BOOST_CHECK(reader.eof());
+  BOOST_REQUIRE_EQUAL(v.size(), count);
+  for (auto i: range<uint32>(0, count))
+    BOOST_CHECK_EQUAL(v[i], i * 7919u);
+  std::fclose(file);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,146 @@
+// Jakub Staroń, 2016-2017
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include "io/fast_writer.h"
+
+using namespace pcl;
+
+BOOST_AUTO_TEST_SUITE(fast_writer_suite)
+
+BOOST_AUTO_TEST_CASE(integers_test) {
+  std::ostringstream stream;
+  {
+    FastWriter writer(stream);
+    writer << 0 << ' ' << 7 << ' ' << 42 << ' ' << -123 << ' ' << 1000000007u << ' ';
+    writer << std::numeric_limits<int64>::min() << ' ' << std::numeric_limits<uint64>::max();
+  }
+  BOOST_CHECK_EQUAL(stream.str(), "0 7 42 -123 1000000007 -9223372036854775808 18446744073709551615");
+}
+
+BOOST_AUTO_TEST_CASE(formatting_matches_ostream_test) {
+  std::ostringstream expected;
+  std::ostringstream stream;
+  {
+    FastWriter writer(stream);
+    for (auto i: range<int64>(-1000, 1000)) {
+      const int64 value = i * i * i * 7919;
+      writer << value << ' ';
+      expected << value << ' ';
+    }
+  }
+  BOOST_CHECK_EQUAL(stream.str(), expected.str());
+}
+
+BOOST_AUTO_TEST_CASE(other_types_test) {
+  std::ostringstream stream;
+  {
+    FastWriter writer(stream);
+    writer << 'c' << "Ala" << std::string(" ma") << ' ' << true << ' ' << 1.5 << ' ' << 0.1;
+    writer << ' ' << numeric::prime_field<5>(9);
+    numeric::dynamic_field<>::setModulus(7);
+    writer << ' ' << numeric::dynamic_field<>(-1);
+    writer.setPrecision(3);
+    writer << ' ' << 2.0 / 3;
+  }
+  BOOST_CHECK_EQUAL(stream.str(), "cAla ma 1 1.5 0.1 4 6 0.667");
+}
+
+BOOST_AUTO_TEST_CASE(printing_test) {
+  {
+    std::ostringstream stream;
+    {
+      FastWriter writer(stream);
+      writer << std::make_pair(1, "Ala") << newline;
+      writer << std::vector<int>{1, 2, 3} << newline;
+      writer << fancy << std::make_tuple(1, std::make_pair("ma", "kota"), 'c') << newline;
+      writer << std::vector<std::pair<int, int>>{{1, 2}, {3, 4}} << simple << newline;
+      writer << std::make_tuple(1, 2) << std::endl;
+    }
+    BOOST_CHECK_EQUAL(stream.str(), "1 Ala\n1 2 3\n(1, (ma, kota), c)\n((1, 2), (3, 4))\n1 2\n");
+  }
+
+  {
+    std::ostringstream stream;
+    {
+      FastWriter writer(stream);
+      print(writer, "");
+      print(writer, "Ala %0 kota", "ma");
+      print(writer, "%%0 %0 %%%0", 42);
+      print(writer, "%0%1 %0", fancy, std::make_pair(1, 2));
+      print(writer, "%0", flush);
+      BOOST_CHECK_EQUAL(stream.str(), "\nAla ma kota\n%0 42 %42\n(1, 2) \n");
+      BOOST_CHECK_THROW(print(writer, "%0 %2", "Ala"), std::exception);
+      BOOST_CHECK_THROW(writer << std::ends, std::invalid_argument);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(compile_time_format_test) {
+  std::ostringstream stream;
+  {
+    FastWriter writer(stream);
+    print(writer, PCL_FORMAT("%0 + %1 = %2%%"), 2, 3, 5);
+    print(writer, PCL_FORMAT("%0%1"), fancy, std::make_pair(1, "Ala"));
+  }
+  BOOST_CHECK_EQUAL(stream.str(), "2 + 3 = 5%\n(1, Ala)\n");
+}
+
+BOOST_AUTO_TEST_CASE(asynchronous_test) {
+  // Output bigger than buffer, so background thread writes several buffers.
+  constexpr uint32 count = 100 * 1000;
+  std::string expected;
+  for (auto i: range<uint32>(0, count))
+    expected += std::to_string(i * 7919u) + "\n";
+  std::string big(FastWriter::kBufferSize + 1, 'x');
+
+  std::FILE* file = std::tmpfile();
+  BOOST_REQUIRE(file != nullptr);
+  {
+    FastWriter writer(file, writer_mode::asynchronous);
+    for (auto i: range<uint32>(0, count))
+      writer << i * 7919u << newline;
+    writer << flush;
+    BOOST_CHECK_EQUAL(std::ftell(file), long(expected.size()));
+    writer << big;
+  }
+  expected += big;
+  std::rewind(file);
+  std::string result(expected.size() + 1, '\0');
+  result.resize(std::fread(&result[0], 1, result.size(), file));
+  BOOST_CHECK(result == expected);
+  std::fclose(file);
+
+  std::ostringstream stream;
+  {
+    FastWriter writer(stream, writer_mode::asynchronous);
+    print(writer, "%0 %1", 1, "Ala");
+  }
+  BOOST_CHECK_EQUAL(stream.str(), "1 Ala\n");
+}
+
+BOOST_AUTO_TEST_CASE(file_test) {
+  // Output bigger than buffer.
+  constexpr uint32 count = 100 * 1000;
+  std::FILE* file = std::tmpfile();
+  BOOST_REQUIRE(file != nullptr);
+  std::string expected;
+  {
+    FastWriter writer(file);
+    for (auto i: range<uint32>(0, count)) {
+      print(writer, "%0", i);
+      expected += std::to_string(i);
+      expected += '\n';
+    }
+    writer << std::string(FastWriter::kBufferSize + 10, 'x');
+    expected += std::string(FastWriter::kBufferSize + 10, 'x');
+  }
+  std::rewind(file);
+  std::string result(expected.size() + 1, '\0');
+  result.resize(std::fread(&result[0], 1, result.size(), file));
+  BOOST_CHECK(result == expected);
+  std::fclose(file);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,103 @@
+// Jakub Staroń, 2016-2017
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include "numeric/field_arrays.h"
+#include "numeric/ntt.h"
+
+using namespace pcl;
+using namespace pcl::numeric;
+
+namespace {
+
+using numeric::detail::simd_level;
+
+/**
+ * Returns instruction sets supported by this machine.
+ */
+std::vector<simd_level> supported_levels() {
+  std::vector<simd_level> result;
+  for (auto level: {simd_level::kScalar, simd_level::kSse4, simd_level::kAvx2})
+    if (level <= numeric::detail::detect_simd_level())
+      result.push_back(level);
+  return result;
+}
+
+template <uint32 prime>
+std::vector<prime_field<prime>> random_values(size_t size) {
+  std::vector<prime_field<prime>> result;
+  for (auto i: range<size_t>(0, size))
+    result.push_back(Random32());
+  if (size > 2) {
+    result[0] = 0;
+    result[1] = prime - 1;
+  }
+  return result;
+}
+
+template <uint32 prime>
+void check_operations() {
+  using field = prime_field<prime>;
+  for (size_t size: {0, 1, 3, 4, 7, 8, 9, 31, 1000}) {
+    const auto a = random_values<prime>(size);
+    const auto b = random_values<prime>(size);
+    const field scalar = Random32();
+    std::vector<field> sum(size), difference(size), product(size), fma = a, axpy = b;
+    field dot = 0;
+    for (auto i: range<size_t>(0, size)) {
+      sum[i] = a[i] + b[i];
+      difference[i] = a[i] - b[i];
+      product[i] = a[i] * b[i];
+      fma[i] += a[i] * b[i];
+      axpy[i] += scalar * a[i];
+      dot += a[i] * b[i];
+    }
+
+    std::vector<field> result(size);
+    FieldAdd(a.data(), b.data(), result.data(), size);
+    BOOST_CHECK(result == sum);
+    FieldSubtract(a.data(), b.data(), result.data(), size);
+    BOOST_CHECK(result == difference);
+    FieldMultiply(a.data(), b.data(), result.data(), size);
+    BOOST_CHECK(result == product);
+    result = a;
+    FieldMultiplyAdd(a.data(), b.data(), result.data(), size);
+    BOOST_CHECK(result == fma);
+    result = b;
+    FieldScaleAdd(a.data(), scalar, result.data(), size);
+    BOOST_CHECK(result == axpy);
+    BOOST_CHECK_EQUAL(FieldDotProduct(a.data(), b.data(), size), dot);
+
+    result = a;
+    FieldAdd(result.data(), b.data(), result.data(), size);
+    BOOST_CHECK(result == sum);
+  }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(field_arrays_suite)
+
+BOOST_AUTO_TEST_CASE(operations_test) {
+  const simd_level original = numeric::detail::field_simd_level();
+  for (auto level: supported_levels()) {
+    BOOST_TEST_MESSAGE("simd level " << int(level));
+    numeric::detail::field_simd_level() = level;
+    check_operations<kNttPrime1>();
+    check_operations<uint32_prime1>();
+    check_operations<uint32_prime2>();
+    check_operations<1000000007>();
+    check_operations<3>();
+    check_operations<2>();
+  }
+  numeric::detail::field_simd_level() = original;
+}
+
+BOOST_AUTO_TEST_CASE(constants_test) {
+  constexpr auto constants = numeric::detail::make_field_constants<kNttPrime1>();
+  BOOST_CHECK_EQUAL(constants.prime * constants.inverse, 1);
+  BOOST_CHECK_EQUAL(constants.square, (uint64(1) << 32) % kNttPrime1 * ((uint64(1) << 32) % kNttPrime1) % kNttPrime1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -147,6 +147,39 @@ BOOST_AUTO_TEST_CASE(print_test) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(print_compile_time_format_test) {
+  {
+    std::ostringstream stream;
+    print(stream, PCL_FORMAT(""));
+    BOOST_CHECK_EQUAL(stream.str(), "\n");
+  }
+
+  {
+    std::ostringstream stream;
+    print(stream, PCL_FORMAT("Ala %0 kota"), "ma");
+    BOOST_CHECK_EQUAL(stream.str(), "Ala ma kota\n");
+  }
+
+  {
+    std::ostringstream stream;
+    Noncopyable non;
+    print(stream, PCL_FORMAT("%0 %1 %0 %2"), "Ala", "kota", non);
+    BOOST_CHECK_EQUAL(stream.str(), "Ala kota Ala noncopyable\n");
+  }
+
+  {
+    std::ostringstream stream;
+    print(stream, PCL_FORMAT("%%0 %0 %%%0%%"), "Ala");
+    BOOST_CHECK_EQUAL(stream.str(), "%0 Ala %Ala%\n");
+  }
+
+  {
+    std::ostringstream stream;
+    print(stream, PCL_FORMAT("%0%1 %2%3"), std::boolalpha, true, fancy, std::make_pair(1, 2));
+    BOOST_CHECK_EQUAL(stream.str(), "true (1, 2)\n");
+  }
+}
+
 BOOST_AUTO_TEST_CASE(pair_tuple_input_test) {
   {
     std::istringstream stream("1 2");
@@ -354,4 +387,52 @@ BOOST_AUTO_TEST_CASE(sequence_reader_test) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(read_into_test) {
+  {
+    std::istringstream stream("1 2 3 4");
+    int data[3];
+    ReadInto(stream, data, 3);
+    BOOST_CHECK_EQUAL(data[0], 1);
+    BOOST_CHECK_EQUAL(data[1], 2);
+    BOOST_CHECK_EQUAL(data[2], 3);
+  }
+
+  {
+    std::istringstream stream("1 2 3 4");
+    std::vector<uint32_pair> v(10);
+    ReadInto(stream, v, 2);
+    std::vector<uint32_pair> expected = {{1, 2}, {3, 4}};
+    BOOST_CHECK(v == expected);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(read_columns_test) {
+  {
+    std::istringstream stream("1 2 3 4 5 6");
+    auto columns = ReadColumns<std::pair<int, int64>>(stream, 3);
+    std::vector<int> first = {1, 3, 5};
+    std::vector<int64> second = {2, 4, 6};
+    BOOST_CHECK(columns.first == first);
+    BOOST_CHECK(columns.second == second);
+  }
+
+  {
+    std::istringstream stream("Ala 1 a ma 2 b");
+    auto columns = ReadColumns<std::tuple<std::string, int, char>>(stream, 2);
+    std::vector<std::string> first = {"Ala", "ma"};
+    std::vector<int> second = {1, 2};
+    std::vector<char> third = {'a', 'b'};
+    BOOST_CHECK(std::get<0>(columns) == first);
+    BOOST_CHECK(std::get<1>(columns) == second);
+    BOOST_CHECK(std::get<2>(columns) == third);
+  }
+
+  {
+    std::istringstream stream;
+    auto columns = ReadColumns<std::pair<int, int>>(stream, 0);
+    BOOST_CHECK(columns.first.empty());
+    BOOST_CHECK(columns.second.empty());
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
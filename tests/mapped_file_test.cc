@@ -0,0 +1,93 @@
+// Jakub Staroń, 2016-2017
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include "io/mapped_file.h"
+
+using namespace pcl;
+
+BOOST_AUTO_TEST_SUITE(mapped_file_suite)
+
+struct TemporaryFile {
+  explicit TemporaryFile(const std::string& text):
+      file(std::tmpfile()) {
+    std::fwrite(text.data(), 1, text.size(), file);
+    std::fflush(file);
+  }
+
+  ~TemporaryFile() {
+    std::fclose(file);
+  }
+
+  int fd() const {
+    return fileno(file);
+  }
+
+  std::FILE* file;
+};
+
+std::vector<std::string> MappedLines(const std::string& text) {
+  TemporaryFile temporary(text);
+  MappedFile file(temporary.fd());
+  std::vector<std::string> result;
+  for (auto line: iterate(Lines(file)))
+    result.push_back(line.str());
+  return result;
+}
+
+std::vector<std::string> StreamLines(const std::string& text) {
+  std::istringstream stream(text);
+  auto range = iterate(Lines(stream));
+  return std::vector<std::string>(range.begin(), range.end());
+}
+
+BOOST_AUTO_TEST_CASE(lines_test) {
+  std::vector<std::string> texts = {"", "Ala", "Ala\n", "Ala\nma\n\nkota", "\n\n"};
+  for (const auto& text: texts) {
+    BOOST_CHECK(MappedLines(text) == StreamLines(text));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(mapping_test) {
+  TemporaryFile temporary("Ala ma kota");
+  MappedFile file(temporary.fd());
+  BOOST_CHECK_EQUAL(file.size(), 11u);
+  BOOST_CHECK(string_slice(file.begin(), file.size()) == string_slice("Ala ma kota"));
+
+  MappedFile moved(std::move(file));
+  BOOST_CHECK_EQUAL(moved.size(), 11u);
+  BOOST_CHECK_EQUAL(file.size(), 0u);
+
+  BOOST_CHECK_THROW(MappedFile("/nonexistent/file"), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(read_sequence_test) {
+  TemporaryFile temporary("3\n1 2\n3 4\n5 6\n");
+  MappedFile file(temporary.fd());
+  auto reader = file.reader();
+  uint32 n;
+  read(reader, n);
+  BOOST_CHECK_EQUAL(n, 3);
+  auto pairs = as_vector(ReadSequence<uint32_pair>(reader, n));
+  std::vector<uint32_pair> expected = {{1, 2}, {3, 4}, {5, 6}};
+  BOOST_CHECK(pairs == expected);
+
+  auto numbers = as_vector(ReadSequence<int>(file, 3));
+  std::vector<int> expected_numbers = {3, 1, 2};
+  BOOST_CHECK(numbers == expected_numbers);
+}
+
+BOOST_AUTO_TEST_CASE(string_slice_test) {
+  std::string text = "Ala ma kota";
+  string_slice slice(text.data(), 3);
+  BOOST_CHECK_EQUAL(slice.size(), 3u);
+  BOOST_CHECK(slice == string_slice("Ala"));
+  BOOST_CHECK(slice != string_slice("ma"));
+  BOOST_CHECK(string_slice("Ala") < string_slice("ma"));
+  std::ostringstream stream;
+  stream << slice;
+  BOOST_CHECK_EQUAL(stream.str(), "Ala");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
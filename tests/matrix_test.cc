@@ -0,0 +1,126 @@
+// Jakub Staroń, 2016-2017
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include "numeric/matrix.h"
+#include "numeric/dynamic_field.h"
+
+using namespace pcl;
+using namespace pcl::numeric;
+
+namespace {
+
+using field = prime_field<1000000007>;
+
+template <typename Value>
+Matrix<Value> random_matrix(uint32 rows, uint32 columns) {
+  Matrix<Value> result(rows, columns);
+  for (auto i: range<uint32>(0, rows))
+    for (auto j: range<uint32>(0, columns))
+      result(i, j) = Random32();
+  return result;
+}
+
+template <typename Value>
+Matrix<Value> naive_product(const Matrix<Value>& a, const Matrix<Value>& b) {
+  Matrix<Value> result(a.rows(), b.columns());
+  for (auto i: range<uint32>(0, a.rows()))
+    for (auto j: range<uint32>(0, b.columns()))
+      for (auto k: range<uint32>(0, a.columns()))
+        result(i, j) += a(i, k) * b(k, j);
+  return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(matrix_suite)
+
+BOOST_AUTO_TEST_CASE(creation_test) {
+  Matrix<field> m = {{1, 2, 3}, {4, 5, 6}};
+  BOOST_CHECK_EQUAL(m.rows(), 2);
+  BOOST_CHECK_EQUAL(m.columns(), 3);
+  BOOST_CHECK_EQUAL(m(1, 2), 6);
+  BOOST_CHECK_EQUAL(m.row(1)[0], 4);
+  BOOST_CHECK(Matrix<field>(2, 3, 7) != m);
+  BOOST_CHECK(Matrix<field>::identity(2) == Matrix<field>({{1, 0}, {0, 1}}));
+  BOOST_CHECK_THROW(Matrix<field>({{1, 2}, {3}}), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(arithmetic_test) {
+  Matrix<field> a = {{1, 2}, {3, 4}}, b = {{0, 1}, {1, 0}};
+  BOOST_CHECK(a * b == Matrix<field>({{2, 1}, {4, 3}}));
+  BOOST_CHECK(a + b == Matrix<field>({{1, 3}, {4, 4}}));
+  BOOST_CHECK(a - b == Matrix<field>({{1, 1}, {2, 4}}));
+  BOOST_CHECK(a * std::vector<field>({1, -1}) == std::vector<field>({-1, -1}));
+  a *= b;
+  BOOST_CHECK(a == Matrix<field>({{2, 1}, {4, 3}}));
+  BOOST_CHECK_THROW(a * Matrix<field>(3, 3), std::invalid_argument);
+  BOOST_CHECK_THROW(a + Matrix<field>(2, 3), std::invalid_argument);
+  BOOST_CHECK_THROW(a * std::vector<field>(3), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(multiplication_test) {
+  for (auto sizes: std::vector<std::array<uint32, 3>>{{{1, 1, 1}}, {{3, 300, 5}}, {{70, 130, 300}}}) {
+    const auto a = random_matrix<field>(sizes[0], sizes[1]);
+    const auto b = random_matrix<field>(sizes[1], sizes[2]);
+    BOOST_CHECK(a * b == naive_product(a, b));
+
+    using big_field = prime_field<uint32_prime1>;
+    const auto c = random_matrix<big_field>(sizes[0], sizes[1]);
+    const auto d = random_matrix<big_field>(sizes[1], sizes[2]);
+    BOOST_CHECK(c * d == naive_product(c, d));
+
+    const auto e = random_matrix<prime_field<2>>(sizes[0], sizes[1]);
+    const auto f = random_matrix<prime_field<2>>(sizes[1], sizes[2]);
+    BOOST_CHECK(e * f == naive_product(e, f));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(power_test) {
+  const Matrix<field> fibonacci = {{1, 1}, {1, 0}};
+  BOOST_CHECK(power(fibonacci, 0) == Matrix<field>::identity(2));
+  BOOST_CHECK_EQUAL(power(fibonacci, 10)(0, 1), 55);
+  BOOST_CHECK_EQUAL(power(fibonacci, 1000000)(0, 1), 918091266);
+  BOOST_CHECK_THROW(power(Matrix<field>(2, 3), 2), std::invalid_argument);
+
+  const auto a = random_matrix<field>(10, 10);
+  BOOST_CHECK(power(a, 5) == a * a * a * a * a);
+}
+
+BOOST_AUTO_TEST_CASE(elimination_test) {
+  Matrix<prime_field<7>> m = {{1, 2, 3}, {2, 4, 1}};
+  BOOST_CHECK_EQUAL(GaussianElimination(m), 2);
+  BOOST_CHECK(m == Matrix<prime_field<7>>({{1, 2, 0}, {0, 0, 1}}));
+
+  BOOST_CHECK_EQUAL(Rank(Matrix<field>({{1, 2}, {2, 4}, {3, 6}})), 1);
+  BOOST_CHECK_EQUAL(Rank(Matrix<field>(3, 4)), 0);
+  BOOST_CHECK_EQUAL(Rank(Matrix<field>::identity(5)), 5);
+  BOOST_CHECK_EQUAL(Rank(random_matrix<field>(20, 50)), 20);
+
+  const auto a = random_matrix<field>(30, 30);
+  auto inverse = a;
+  BOOST_CHECK_EQUAL(GaussianElimination(inverse), 30);
+  BOOST_CHECK(inverse == Matrix<field>::identity(30));
+}
+
+BOOST_AUTO_TEST_CASE(determinant_test) {
+  BOOST_CHECK_EQUAL(Determinant(Matrix<field>({{1, 2}, {3, 4}})), -2);
+  BOOST_CHECK_EQUAL(Determinant(Matrix<field>({{0, 1}, {1, 0}})), -1);
+  BOOST_CHECK_EQUAL(Determinant(Matrix<field>({{1, 2}, {2, 4}})), 0);
+  BOOST_CHECK_EQUAL(Determinant(Matrix<field>::identity(4)), 1);
+  BOOST_CHECK_THROW(Determinant(Matrix<field>(2, 3)), std::invalid_argument);
+
+  const auto a = random_matrix<field>(40, 40);
+  const auto b = random_matrix<field>(40, 40);
+  BOOST_CHECK_EQUAL(Determinant(a * b), Determinant(a) * Determinant(b));
+
+  struct modulus;
+  using runtime_field = dynamic_field<modulus>;
+  runtime_field::setModulus(1000000007);
+  const Matrix<runtime_field> c = {{2, 0, 1}, {1, 3, 2}, {1, 1, 2}};
+  BOOST_CHECK_EQUAL(Determinant(c), 6);
+  BOOST_CHECK(power(c, 3) == c * c * c);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,68 @@
+// Jakub Staroń, 2016-2017
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include "iterators.h"
+#include "numeric/multiplicative_functions.h"
+#include "numeric/number_theory.h"
+
+using namespace pcl;
+using namespace pcl::numeric;
+
+BOOST_AUTO_TEST_SUITE(multiplicative_functions_suite)
+
+BOOST_AUTO_TEST_CASE(small_values_test) {
+  BOOST_CHECK(TotientFunctionValues(0).empty());
+  BOOST_CHECK(TotientFunctionValues(1) == std::vector<uint32>({0}));
+  BOOST_CHECK(TotientFunctionValues(10) == std::vector<uint32>({0, 1, 1, 2, 2, 4, 2, 6, 4, 6}));
+  BOOST_CHECK(MobiusFunctionValues(11) == std::vector<int8>({0, 1, -1, -1, 0, -1, 1, -1, 0, 0, 1}));
+  BOOST_CHECK(DivisorCountValues(13) == std::vector<uint32>({0, 1, 2, 2, 3, 2, 4, 2, 4, 3, 4, 2, 6}));
+  BOOST_CHECK(DivisorSumValues(13) == std::vector<uint64>({0, 1, 3, 4, 7, 6, 12, 8, 15, 13, 18, 12, 28}));
+}
+
+BOOST_AUTO_TEST_CASE(brute_force_test) {
+  const uint32 n = 5000;
+  const auto totient = TotientFunctionValues(n);
+  const auto mobius = MobiusFunctionValues(n);
+  const auto count = DivisorCountValues(n);
+  const auto sum = DivisorSumValues(n);
+  for (auto k: range<uint32>(1, n)) {
+    uint32 coprime = 0;
+    for (auto i: range<uint32>(1, k + 1))
+      coprime += (GCD(i, k) == 1);
+    BOOST_CHECK_EQUAL(totient[k], coprime);
+
+    const auto divisors = Divisors(k);
+    BOOST_CHECK_EQUAL(count[k], divisors.size());
+    BOOST_CHECK_EQUAL(sum[k], std::accumulate(divisors.begin(), divisors.end(), uint64(0)));
+
+    const auto factors = Factorize(k);
+    const bool square_free = std::adjacent_find(factors.begin(), factors.end()) == factors.end();
+    BOOST_CHECK_EQUAL(int(mobius[k]), square_free? ((factors.size() % 2 == 0)? 1 : -1) : 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(custom_function_test) {
+  // f(n) = n
+  const auto identity = MultiplicativeFunctionValues<uint64>(1000, [](uint32, uint32, uint32 q) {
+    return q;
+  });
+  for (auto k: range<uint32>(0, 1000))
+    BOOST_CHECK_EQUAL(identity[k], k);
+
+  // f(p^k) is called for every prime power exactly once
+  std::vector<uint32> calls(1000, 0);
+  MultiplicativeFunctionValues<uint32>(1000, [&calls](uint32 p, uint32 k, uint32 q) {
+    calls[q]++;
+    BOOST_CHECK_EQUAL(power(int64(p), k), q);
+    return 1;
+  });
+  for (auto k: range<uint32>(2, 1000)) {
+    const auto factors = Factorize(k);
+    const bool prime_power = factors.front() == factors.back();
+    BOOST_CHECK_EQUAL(calls[k], prime_power? 1 : 0);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
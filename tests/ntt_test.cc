@@ -0,0 +1,122 @@
+// Jakub Staroń, 2016-2017
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include "numeric/ntt.h"
+
+using namespace pcl;
+using namespace pcl::numeric;
+
+namespace {
+
+using field = prime_field<kNttPrime1>;
+
+std::vector<field> random_polynomial(size_t size) {
+  std::vector<field> result;
+  for (auto i: range<size_t>(0, size))
+    result.push_back(Random32());
+  return result;
+}
+
+std::vector<uint64> naive_convolution(const std::vector<uint64>& a, const std::vector<uint64>& b,
+                                      uint64 modulo) {
+  std::vector<uint64> result(a.size() + b.size() - 1, 0);
+  for (auto i: range<size_t>(0, a.size()))
+    for (auto j: range<size_t>(0, b.size()))
+      result[i + j] = Add64(result[i + j], Multiply64(a[i], b[j], modulo), modulo);
+  return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(ntt_suite)
+
+BOOST_AUTO_TEST_CASE(transform_test) {
+  std::vector<field> v = {1, 2, 3, 4};
+  NumberTheoreticTransform(v);
+  BOOST_CHECK_EQUAL(v[0], 10);
+  NumberTheoreticTransform(v, true);
+  BOOST_CHECK(v == std::vector<field>({1, 2, 3, 4}));
+
+  for (size_t size: {1, 2, 8, 1 << 12}) {
+    const auto original = random_polynomial(size);
+    auto transformed = original;
+    NumberTheoreticTransform(transformed);
+    const field w = power(field(3), (kNttPrime1 - 1) / size); // 3 is primitive root
+    field x = 1, value = 0;
+    for (auto coefficient: original) {
+      value += coefficient * x;
+      x *= w;
+    }
+    BOOST_CHECK_EQUAL(transformed[1 % size], value); // value at w
+    NumberTheoreticTransform(transformed, true);
+    BOOST_CHECK(transformed == original);
+  }
+
+  std::vector<field> empty, odd(3), big(size_t(1) << 24);
+  BOOST_CHECK_THROW(NumberTheoreticTransform(empty), std::invalid_argument);
+  BOOST_CHECK_THROW(NumberTheoreticTransform(odd), std::invalid_argument);
+  BOOST_CHECK_THROW(NumberTheoreticTransform(big), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(convolution_test) {
+  BOOST_CHECK(Convolution(std::vector<field>(), random_polynomial(10)).empty());
+  for (auto sizes: std::vector<std::pair<size_t, size_t>>{{1, 1}, {5, 40}, {33, 33}, {100, 1000}, {1000, 1}}) {
+    const auto a = random_polynomial(sizes.first);
+    const auto b = random_polynomial(sizes.second);
+    const auto result = Convolution(a, b);
+    BOOST_REQUIRE_EQUAL(result.size(), a.size() + b.size() - 1);
+    BOOST_CHECK(result == numeric::detail::naive_convolution(a, b));
+    BOOST_CHECK(Convolution(a, a) == numeric::detail::naive_convolution(a, a));
+  }
+
+  const auto c = Convolution(std::vector<prime_field<kNttPrime3>>(1000, 1),
+                             std::vector<prime_field<kNttPrime3>>(1000, 1));
+  for (auto i: range<size_t>(0, c.size()))
+    BOOST_CHECK_EQUAL(c[i], std::min(i + 1, c.size() - i));
+}
+
+BOOST_AUTO_TEST_CASE(convolution_modulo_test) {
+  BOOST_CHECK(ConvolutionModulo({1, 2}, {3, 4}, 1000000007) == std::vector<uint64>({3, 10, 8}));
+  BOOST_CHECK(ConvolutionModulo({}, {3, 4}, 7).empty());
+  BOOST_CHECK_THROW(ConvolutionModulo({1}, {1}, 0), std::invalid_argument);
+  BOOST_CHECK_THROW(ConvolutionModulo(std::vector<uint64>(100), std::vector<uint64>(100), 1uLL << 40),
+                    std::invalid_argument);
+
+  for (uint64 modulo: {2uLL, 1000000007uLL, (1uLL << 31) - 1, 1uLL << 32, 1uLL << 40}) {
+    std::vector<uint64> a, b;
+    for (auto i: range<uint32>(0, 50))
+      a.push_back(Random64());
+    for (auto i: range<uint32>(0, modulo > (1uLL << 32)? 1 : 70))
+      b.push_back(Random64());
+    std::vector<uint64> ra, rb;
+    for (auto x: a)
+      ra.push_back(x % modulo);
+    for (auto x: b)
+      rb.push_back(x % modulo);
+    BOOST_CHECK(ConvolutionModulo(a, b, modulo) == naive_convolution(ra, rb, modulo));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(convolution64_test) {
+  BOOST_CHECK(Convolution64({1000000, 2}, {3000000, 4}) ==
+              std::vector<uint64>({3000000000000, 10000000, 8}));
+
+  std::vector<uint64> a, b;
+  for (auto i: range<uint32>(0, 3000)) {
+    a.push_back(Random32() % (1u << 20));
+    b.push_back(Random32() % (1u << 20));
+  }
+  const auto result = Convolution64(a, b);
+  BOOST_REQUIRE_EQUAL(result.size(), a.size() + b.size() - 1);
+  for (auto k: range<size_t>(0, 100)) {
+    const size_t i = Random32() % result.size();
+    uint64 expected = 0;
+    for (size_t j = (i >= b.size())? i - b.size() + 1 : 0; j <= i && j < a.size(); j++)
+      expected += a[j] * b[i - j];
+    BOOST_CHECK_EQUAL(result[i], expected);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -6,17 +6,34 @@
 #include "iterators.h"
 #include "io.h"
 #include "numeric/number_theory.h"
+#include "numeric/prime_field.h"
 
 using namespace pcl::numeric;
 
 BOOST_AUTO_TEST_SUITE(number_theory_test)
 
 BOOST_AUTO_TEST_CASE(gcd_test) {
+  using namespace pcl;
+
   BOOST_CHECK_EQUAL(GCD(1, 1), 1);
   BOOST_CHECK_EQUAL(GCD(8, 12), 4);
   BOOST_CHECK_EQUAL(GCD(100, 43), 1);
   BOOST_CHECK_EQUAL(GCD((1uLL << 63) + 16, (1uLL << 62) + 16), 16);
   BOOST_CHECK_EQUAL(GCD((1uLL << 63) + (1uLL << 42), (1uLL << 63) + (1uLL << 41)), (1uLL << 41));
+  BOOST_CHECK_EQUAL(GCD(0, 0), 0);
+  BOOST_CHECK_EQUAL(GCD(0, 12), 12);
+  BOOST_CHECK_EQUAL(GCD(12, 0), 12);
+  BOOST_CHECK_EQUAL(GCD(~0uLL, ~0uLL), ~0uLL);
+
+  for (int i = 0; i < 10000; i++) {
+    const uint64 common = Random64() >> (Random32() % 64);
+    const uint64 a = (Random64() >> (Random32() % 64)) * common;
+    const uint64 b = (Random64() >> (Random32() % 64)) * common;
+    uint64 x = a, y = b;
+    while (x != 0)
+      std::tie(x, y) = std::make_pair(y % x, x);
+    BOOST_CHECK_EQUAL(GCD(a, b), y);
+  }
 }
 
 BOOST_AUTO_TEST_CASE(extended_gcd_test) {
@@ -62,6 +79,21 @@ BOOST_AUTO_TEST_CASE(merge_congruences_test) {
           {9, 12},
           {45, 48}
       },
+      test_type {
+          {123456789, 4294967291},
+          {987654321, 4294967279},
+          {309308344532033940, 18446743979220271189uLL}
+      },
+      test_type {
+          {5, 3uLL << 40},
+          {6291461, 7uLL * 3 << 20},
+          {13194139533317, 23089744183296}
+      },
+      test_type {
+          {1, 21},
+          {2, 1uLL << 50},
+          {5629499534213122, 23643898043695104}
+      },
   };
 
   for(const auto& test: tests) {
@@ -129,11 +161,30 @@ BOOST_AUTO_TEST_CASE(operations_32bits_test) {
   BOOST_CHECK_EQUAL(Multiply32((1u << 31) - 1, (1u << 31) - 2, (1u << 31)), 2);
 }
 
+BOOST_AUTO_TEST_CASE(operations_64bits_test) {
+  BOOST_CHECK_EQUAL(Add64(4, 5, 6), 3);
+  BOOST_CHECK_EQUAL(Add64(~0uLL, ~0uLL, 10), 0);
+  BOOST_CHECK_EQUAL(Add64(~0uLL - 1, ~0uLL - 1, ~0uLL), ~0uLL - 2);
+
+  BOOST_CHECK_EQUAL(Subtract64(4, 5, 6), 5);
+  BOOST_CHECK_EQUAL(Subtract64(7, ~0uLL, 10), 2);
+  BOOST_CHECK_EQUAL(Subtract64(0, ~0uLL - 1, ~0uLL), 1);
+
+  BOOST_CHECK_EQUAL(Multiply64(4, 5, 6), 2);
+  BOOST_CHECK_EQUAL(Multiply64(~0uLL, 3, 10), 5);
+  BOOST_CHECK_EQUAL(Multiply64(~0uLL - 1, ~0uLL - 1, ~0uLL), 1);
+}
+
 BOOST_AUTO_TEST_CASE(power_modulo_test) {
   pcl::uint64 modulo = pcl::power(10, 9) + 7;
   BOOST_CHECK_EQUAL(PowerModulo32(2, pcl::power(10, 17), modulo), 952065854);
   BOOST_CHECK_EQUAL(PowerModulo32(3, pcl::power(10, 17), modulo), 368629774);
   BOOST_CHECK_EQUAL(PowerModulo32(3, pcl::power(10, 17) + 1, modulo), 105889315);
+
+  BOOST_CHECK_EQUAL(PowerModulo64(3, pcl::power(10, 18), 18446744073709551557uLL), 4014180641660839766uLL);
+  BOOST_CHECK_EQUAL(PowerModulo64(2, ~0uLL, 18446744073709551557uLL), 576460752303423488uLL);
+  BOOST_CHECK_EQUAL(PowerModulo64(5, 12345678901234567uLL, (1uLL << 63) + 1), 1799054537710017938uLL);
+  BOOST_CHECK_EQUAL(PowerModulo64(7, pcl::power(10, 18), ~0uLL - 1), 13499231876638320547uLL);
 }
 
 BOOST_AUTO_TEST_CASE(divisors_test) {
@@ -169,6 +220,27 @@ BOOST_AUTO_TEST_CASE(divisors_test) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(divisors_from_factorization_test) {
+  using namespace pcl;
+
+  BOOST_CHECK(DivisorsFromFactorization({}) == std::vector<uint32>({1}));
+  BOOST_CHECK(DivisorsFromFactorization({2, 2, 3}) == std::vector<uint32>({1, 2, 3, 4, 6, 12}));
+  BOOST_CHECK(Divisors(0).empty());
+  for (uint32 n = 1; n < 100000; n += 7) {
+    const auto divisors = Divisors(n);
+    BOOST_CHECK(std::is_sorted(divisors.begin(), divisors.end()));
+    auto unsorted = DivisorsFromFactorization(Factorize(n), false);
+    std::sort(unsorted.begin(), unsorted.end());
+    BOOST_CHECK(unsorted == divisors);
+  }
+  const auto divisors = Divisors(735134400); // 1344 divisors
+  BOOST_CHECK_EQUAL(divisors.size(), 1344);
+  for (auto d: divisors)
+    BOOST_CHECK_EQUAL(735134400 % d, 0);
+  BOOST_CHECK(std::is_sorted(divisors.begin(), divisors.end()));
+  BOOST_CHECK(std::adjacent_find(divisors.begin(), divisors.end()) == divisors.end());
+}
+
 BOOST_AUTO_TEST_CASE(prime_divisors_test) {
   using namespace pcl;
 
@@ -248,6 +320,65 @@ BOOST_AUTO_TEST_CASE(factorization_test) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(factorize64_test) {
+  using namespace pcl;
+
+  BOOST_CHECK_THROW(Factorize64(0), std::invalid_argument);
+  BOOST_CHECK(Factorize64(1).empty());
+  BOOST_CHECK(Factorize64(2) == std::vector<uint64>({2}));
+  BOOST_CHECK(Factorize64(998244359987710471uLL) == std::vector<uint64>({998244353, 1000000007}));
+  BOOST_CHECK(Factorize64(18446743979220271189uLL) == std::vector<uint64>({4294967279uLL, 4294967291uLL}));
+  BOOST_CHECK(Factorize64(18446744073709551557uLL) == std::vector<uint64>({18446744073709551557uLL}));
+  BOOST_CHECK(Factorize64(1uLL << 63) == std::vector<uint64>(63, 2));
+  BOOST_CHECK(Factorize64(1000003uLL * 1000003 * 3 * 3) == std::vector<uint64>({3, 3, 1000003, 1000003}));
+  BOOST_CHECK(Factorize64(9746347772161uLL) == std::vector<uint64>({7, 11, 13, 17, 19, 31, 37, 41, 641}));
+
+  for (auto i: range<uint32>(0, 1000)) {
+    const uint32 n = Random32() % std::numeric_limits<uint32>::max() + 1;
+    const auto expected = Factorize(n);
+    BOOST_CHECK(Factorize64(n) == std::vector<uint64>(expected.begin(), expected.end()));
+  }
+
+  for (auto i: range<uint32>(0, 100)) {
+    const uint64 n = Random64() | 1;
+    auto factorization = Factorize64(n);
+    BOOST_CHECK(std::is_sorted(factorization.begin(), factorization.end()));
+    BOOST_CHECK(std::all_of(factorization.begin(), factorization.end(), IsPrime));
+    uint64 product = 1;
+    for (auto p: factorization)
+      product *= p;
+    BOOST_CHECK_EQUAL(product, n);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(montgomery_test) {
+  using namespace pcl;
+
+  BOOST_CHECK_THROW(Montgomery64(10), std::invalid_argument);
+  for (uint64 modulus: {3uLL, 1000000007uLL, 18446744073709551557uLL, (1uLL << 63) + 1}) {
+    Montgomery64 context(modulus);
+    BOOST_CHECK_EQUAL(context.fromMontgomery(context.one()), 1);
+    for (auto i: range<uint32>(0, 100)) {
+      const uint64 a = Random64() % modulus, b = Random64() % modulus;
+      const uint64 x = context.toMontgomery(a), y = context.toMontgomery(b);
+      BOOST_CHECK_EQUAL(context.fromMontgomery(x), a);
+      BOOST_CHECK_EQUAL(context.fromMontgomery(context.multiply(x, y)), Multiply64(a, b, modulus));
+      BOOST_CHECK_EQUAL(context.fromMontgomery(context.add(x, y)), Add64(a, b, modulus));
+      BOOST_CHECK_EQUAL(context.fromMontgomery(context.subtract(x, y)), Subtract64(a, b, modulus));
+
+      const uint64 n = Random64();
+      BOOST_CHECK_EQUAL(context.power(x, 0), context.one());
+      BOOST_CHECK_EQUAL(context.multiply(context.power(x, n), x), context.power(x, n + 1));
+      if (GCD(a, modulus) == 1)
+        BOOST_CHECK_EQUAL(context.multiply(context.inverse(x), x), context.one());
+    }
+  }
+
+  Montgomery64 context(15);
+  BOOST_CHECK_EQUAL(context.fromMontgomery(context.inverse(context.toMontgomery(7))), 13);
+  BOOST_CHECK_THROW(context.inverse(context.toMontgomery(6)), std::runtime_error);
+}
+
 BOOST_AUTO_TEST_CASE(primes_test) {
   using namespace pcl;
 
@@ -263,9 +394,9 @@ BOOST_AUTO_TEST_CASE(primes_test) {
   BOOST_CHECK(IsPrime(999999999999999989uLL)); // biggest prime smaller than 10^18
   BOOST_CHECK(!IsPrime(999999999999999991uLL));
 
-#ifdef USE_INT128_TYPES
   BOOST_CHECK(IsPrime(uint64_prime1));
-#endif
+  BOOST_CHECK(!IsPrime(18446744073709551615uLL));
+  BOOST_CHECK(!IsPrime(3825123056546413051uLL)); // strong pseudoprime to bases up to 23
 
   // they are not twin primes
   BOOST_CHECK(!IsPrime(uint32_prime1 - 2));
@@ -281,6 +412,167 @@ BOOST_AUTO_TEST_CASE(primes_test) {
   BOOST_CHECK(!IsPrime(340561)); // 13 * 17 * 23 * 67
 }
 
+BOOST_AUTO_TEST_CASE(is_prime_batch_test) {
+  using namespace pcl;
+
+  std::vector<uint64> numbers = {0, 1, 2, 3, 4, 59, 61, 3721, 3763, 341, 9746347772161,
+                                 uint32_prime1, uint64_prime1, uint64_prime1 - 2,
+                                 3825123056546413051uLL, 4759123141, 999999999999999989uLL};
+  for (auto i: range<uint32>(0, 100 * 1000))
+    numbers.push_back(i);
+  for (auto i: range<uint32>(0, 50 * 1000)) {
+    numbers.push_back(Random64() | 1);
+    numbers.push_back(Random32() | 1);
+  }
+
+  for (uint32 threads: {1, 3}) {
+    std::unique_ptr<bool[]> result(new bool[numbers.size()]);
+    IsPrimeBatch(numbers.data(), numbers.size(), result.get(), threads);
+    for (auto i: range<size_t>(0, numbers.size())) {
+      BOOST_CHECK_MESSAGE(result[i] == IsPrime(numbers[i]),
+                          "IsPrimeBatch and IsPrime not equal for " << numbers[i]);
+    }
+  }
+  IsPrimeBatch(nullptr, 0, nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(segmented_sieve_test) {
+  using namespace pcl;
+
+  for (auto n: {0u, 1u, 2u, 3u, 4u, 5u, 64u, 127u, 128u, 129u}) {
+    auto primes = Sieve(n);
+    BOOST_REQUIRE_EQUAL(primes.size(), n);
+    for (auto i: range<uint32>(0, n))
+      BOOST_CHECK_EQUAL(primes[i], IsPrime(i));
+  }
+
+  // Range spans several segments.
+  constexpr uint32 N = 3 * 1000 * 1000;
+  auto primes = PrimeNumbers(N);
+  BOOST_CHECK_EQUAL(primes.size(), 216816);
+  BOOST_CHECK_EQUAL(primes.back(), 2999999);
+  BOOST_CHECK(std::is_sorted(primes.begin(), primes.end()));
+  BOOST_CHECK(std::all_of(primes.begin(), primes.end(), IsPrime));
+
+  constexpr uint64 lo = 1000uLL * 1000 * 1000 * 1000 - 20000;
+  constexpr uint64 hi = 1000uLL * 1000 * 1000 * 1000 + 20000;
+  std::vector<uint64> expected;
+  for (uint64 i = lo; i < hi; i++)
+    if (IsPrime(i))
+      expected.push_back(i);
+  std::vector<uint64> result;
+  ForEachPrime(lo, hi, [&result](uint64 p) { result.push_back(p); });
+  BOOST_CHECK(result == expected);
+  BOOST_CHECK(as_vector(PrimesInRange(lo, hi)) == expected);
+
+  BOOST_CHECK(as_vector(PrimesInRange(0, 12)) == std::vector<uint64>({2, 3, 5, 7, 11}));
+  BOOST_CHECK(as_vector(PrimesInRange(2, 3)) == std::vector<uint64>({2}));
+  BOOST_CHECK(as_vector(PrimesInRange(8, 11)).empty());
+  BOOST_CHECK(as_vector(PrimesInRange(20, 10)).empty());
+  BOOST_CHECK_THROW(PrimesInRange(0, kMaxSegmentedSieveLimit + 1), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_sieve_test) {
+  using namespace pcl;
+
+  constexpr uint32 N = 5 * 1000 * 1000 + 7;
+  const auto primes = PrimeNumbers(N);
+  BOOST_CHECK(Sieve(N, 3) == Sieve(N));
+  for (auto threads: {0u, 2u, 7u})
+    BOOST_CHECK(PrimeNumbers(N, threads) == primes);
+  BOOST_CHECK(PrimeNumbers(2, 4).empty());
+  BOOST_CHECK(PrimeNumbers(3, 4) == std::vector<uint32>({2}));
+
+  BOOST_CHECK_EQUAL(CountPrimes(0, 10 * 1000 * 1000, 4), 664579);
+  BOOST_CHECK_EQUAL(CountPrimes(0, N, 3), primes.size());
+  BOOST_CHECK_EQUAL(CountPrimes(3, 3, 3), 0);
+
+  constexpr uint64 lo = 1000uLL * 1000 * 1000 * 1000;
+  constexpr uint64 hi = lo + 3 * 1000 * 1000;
+  BOOST_CHECK(CollectPrimes(lo, hi, 4) == as_vector(PrimesInRange(lo, hi)));
+  BOOST_CHECK_THROW(CountPrimes(0, kMaxSegmentedSieveLimit + 1, 2), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(prime_count_test) {
+  using namespace pcl;
+
+  constexpr uint32 N = 3000;
+  const auto sieve = Sieve(N);
+  uint64 count = 0, sum = 0;
+  for (auto n: range<uint32>(0, N)) {
+    if (sieve[n]) {
+      count++;
+      sum += n;
+    }
+    BOOST_CHECK_EQUAL(PrimeCount(n), count);
+    BOOST_CHECK_EQUAL(PrimeSum(n), sum);
+  }
+
+  for (auto i: range<uint32>(0, 20)) {
+    const uint32 n = Random32() % (10 * 1000 * 1000);
+    BOOST_CHECK_EQUAL(PrimeCount(n), CountPrimes(0, uint64(n) + 1));
+  }
+  BOOST_CHECK_EQUAL(PrimeSum(2000000), 142913828922uLL);
+  BOOST_CHECK_EQUAL(PrimeCount(10uLL * 1000 * 1000 * 1000), 455052511);
+  BOOST_CHECK_EQUAL(PrimeSum(10uLL * 1000 * 1000 * 1000), 2220822432581729238uLL);
+  BOOST_CHECK_EQUAL(PrimeSum<prime_field<1000000007>>(10uLL * 1000 * 1000 * 1000),
+                    prime_field<1000000007>(2220822432581729238uLL));
+  BOOST_CHECK_EQUAL(PrimeCount(1000uLL * 1000 * 1000 * 1000), 37607912018uLL);
+#ifdef HAVE_INT128_TYPES
+  using uint128_t = unsigned __int128;
+  const uint128_t expected = uint128_t(18435588552uLL) * 1000000000000uLL + 550705911377uLL;
+  BOOST_CHECK(PrimeSum<uint128_t>(1000uLL * 1000 * 1000 * 1000) == expected);
+  BOOST_CHECK(PrimeSum<uint128_t>(10uLL * 1000 * 1000 * 1000) == 2220822432581729238uLL);
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(smallest_prime_factor_table_test) {
+  using namespace pcl;
+
+  constexpr uint32 N = 1000 * 1000;
+  SmallestPrimeFactorTable table(N);
+  BOOST_CHECK_EQUAL(table.size(), N);
+  BOOST_CHECK(table.contains(N - 1));
+  BOOST_CHECK(!table.contains(N));
+  for (auto i: range<uint32>(0, N))
+    BOOST_CHECK_EQUAL(table.isPrime(i), IsPrime(i));
+  BOOST_CHECK_EQUAL(table.smallestPrimeFactor(2), 2);
+  BOOST_CHECK_EQUAL(table.smallestPrimeFactor(999999), 3);
+  BOOST_CHECK_EQUAL(table.smallestPrimeFactor(994009), 997); // 997^2
+  BOOST_CHECK_EQUAL(table.smallestPrimeFactor(999983), 999983);
+  BOOST_CHECK_THROW(table.smallestPrimeFactor(1), std::invalid_argument);
+  BOOST_CHECK_THROW(table.smallestPrimeFactor(N), std::out_of_range);
+  BOOST_CHECK_THROW(table.factorize(0), std::invalid_argument);
+  BOOST_CHECK(table.factorize(1).empty());
+  BOOST_CHECK(table.factorize(360) == std::vector<uint32>({2, 2, 2, 3, 3, 5}));
+  std::vector<uint32> factors = {7};
+  table.factorize(999999, factors);
+  BOOST_CHECK(factors == std::vector<uint32>({3, 3, 3, 7, 11, 13, 37}));
+
+  for (uint32 n = 1; n < N; n += 997)
+    BOOST_CHECK(table.factorize(n) == Factorize(n));
+
+  // Global table is used by other functions.
+  BOOST_CHECK(GlobalSmallestPrimeFactorTable() == nullptr);
+  std::vector<std::vector<uint32>> divisors, prime_divisors;
+  for (uint32 n = 1; n < 5000; n++) {
+    divisors.push_back(Divisors(n));
+    prime_divisors.push_back(PrimeDivisors(n));
+  }
+  const uint32 order = MultiplicativeOrder(2, 4871);
+  BuildSmallestPrimeFactorTable(5000);
+  BOOST_REQUIRE(GlobalSmallestPrimeFactorTable() != nullptr);
+  for (uint32 n = 1; n < 5000; n++) {
+    BOOST_CHECK(Divisors(n) == divisors[n - 1]);
+    BOOST_CHECK(PrimeDivisors(n) == prime_divisors[n - 1]);
+  }
+  BOOST_CHECK_EQUAL(MultiplicativeOrder(2, 4871), order);
+  BOOST_CHECK_EQUAL(MultiplicativeOrder(3, 0xFFFFFFFBu), 2147483645u); // not covered by table
+  BOOST_CHECK(Factorize(0xFFFFFFFBu) == std::vector<uint32>({0xFFFFFFFBu}));
+  ReleaseSmallestPrimeFactorTable();
+  BOOST_CHECK(GlobalSmallestPrimeFactorTable() == nullptr);
+}
+
 BOOST_AUTO_TEST_CASE(is_primitive_root_test) {
   BOOST_CHECK_EQUAL(IsPrimitiveRoot(0, 2), false);
   BOOST_CHECK_EQUAL(IsPrimitiveRoot(1, 2), true);
@@ -297,6 +589,35 @@ BOOST_AUTO_TEST_CASE(is_primitive_root_test) {
   BOOST_CHECK_EQUAL(IsPrimitiveRoot(258, 0xFFFFFFFB), false);
 }
 
+BOOST_AUTO_TEST_CASE(primitive_root_finder_test) {
+  using namespace pcl;
+
+  for (auto p: PrimeNumbers(2000)) {
+    const PrimitiveRootFinder finder(p);
+    const uint32 g = finder.find();
+    BOOST_CHECK_EQUAL(finder.order(g), p - 1);
+    uint32 count = 0, coprime = 0;
+    for (auto a: range<uint32>(1, p)) {
+      uint32 order = 1;
+      for (uint32 x = a; x != 1; x = Multiply32(x, a, p))
+        order++;
+      BOOST_CHECK_EQUAL(finder.order(a), order);
+      BOOST_CHECK_EQUAL(finder.isPrimitiveRoot(a), order == p - 1);
+      BOOST_CHECK(a >= g || order != p - 1);
+      count += (order == p - 1);
+      coprime += (GCD(a, p - 1) == 1);
+    }
+    BOOST_CHECK_EQUAL(count, coprime);
+  }
+
+  const PrimitiveRootFinder finder(998244353);
+  BOOST_CHECK(finder.factorization() == std::vector<uint32>({2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 7, 17}));
+  BOOST_CHECK_EQUAL(finder.find(), 3);
+  BOOST_CHECK_EQUAL(finder.order(998244352), 2);
+  BOOST_CHECK_THROW(finder.order(0), std::runtime_error);
+  BOOST_CHECK_EQUAL(PrimitiveRootFinder(0xFFFFFFFB).find(), 2);
+}
+
 BOOST_AUTO_TEST_CASE(inverse_test) {
   BOOST_CHECK_EQUAL(Inverse(1, 2), 1);
   BOOST_CHECK_EQUAL(Inverse(2, 7), 4);
@@ -305,6 +626,26 @@ BOOST_AUTO_TEST_CASE(inverse_test) {
   BOOST_CHECK_EQUAL(Inverse(1, 13), 1);
 }
 
+BOOST_AUTO_TEST_CASE(batch_inverse_test) {
+  using field = prime_field<1000000007>;
+  BOOST_CHECK(BatchInverse(std::vector<field>()).empty());
+  BOOST_CHECK(BatchInverse(std::vector<field>{1, 2, 3}) == std::vector<field>({1, 500000004, 333333336}));
+
+  std::vector<field> values;
+  for (int i = 0; i < 1000; i++)
+    values.push_back(pcl::Random32() % 1000000006 + 1);
+  const auto inverses = BatchInverse(values);
+  for (size_t i = 0; i < values.size(); i++)
+    BOOST_CHECK_EQUAL(inverses[i] * values[i], 1);
+  values[500] = 0;
+  BOOST_CHECK_THROW(BatchInverse(values), std::runtime_error);
+
+  struct modulus;
+  using runtime_field = dynamic_field<modulus>;
+  runtime_field::setModulus(13);
+  BOOST_CHECK(BatchInverse(std::vector<runtime_field>{2, 3, 12}) == std::vector<runtime_field>({7, 9, 12}));
+}
+
 BOOST_AUTO_TEST_CASE(multiplicative_order_test) {
   BOOST_CHECK_EQUAL(MultiplicativeOrder(1, 2), 1);
   BOOST_CHECK_EQUAL(MultiplicativeOrder(2, 7), 3);
@@ -327,4 +668,41 @@ BOOST_AUTO_TEST_CASE(discrete_logarithm_test) {
   BOOST_CHECK_EQUAL(DiscreteLogarithm(3, 1431655764, 0xFFFFFFFB), 2147483644);
 }
 
+BOOST_AUTO_TEST_CASE(discrete_log_solver_test) {
+  using namespace pcl;
+  for (uint32 p: {2u, 3u, 13u, 97u, 101u}) {
+    for (auto a: range<uint32>(1, p)) {
+      DiscreteLogSolver solver(a, p);
+      BOOST_CHECK_EQUAL(solver.order(), MultiplicativeOrder(a, p));
+      std::vector<int64> expected(p, -1);
+      uint32 x = 1;
+      for (auto k: range<uint32>(0, solver.order())) {
+        expected[x] = k;
+        x = Multiply32(x, a, p);
+      }
+      for (auto x: range<uint32>(1, p)) {
+        if (expected[x] >= 0)
+          BOOST_CHECK_EQUAL(solver.logarithm(x), expected[x]);
+        else
+          BOOST_CHECK_THROW(solver.logarithm(x), std::runtime_error);
+      }
+      BOOST_CHECK_THROW(solver.logarithm(0), std::runtime_error);
+    }
+  }
+  BOOST_CHECK_THROW(DiscreteLogSolver(7, 7), std::runtime_error);
+
+  // 998244353 - 1 = 2^23 * 7 * 17 is smooth, 2147483579 - 1 = 2 * q is not.
+  for (auto setup: std::vector<std::pair<uint32, uint32>>{{3, 998244353}, {2, 2147483579}, {3, 0xFFFFFFFB}}) {
+    for (double factor: {0.25, 1.0, 8.0}) {
+      DiscreteLogSolver solver(setup.first, setup.second, factor);
+      for (auto i: range<uint32>(0, 20)) {
+        const uint32 k = Random32() % solver.order();
+        BOOST_CHECK_EQUAL(solver.logarithm(PowerModulo32(setup.first, k, setup.second)), k);
+      }
+    }
+  }
+  BOOST_CHECK_EQUAL(DiscreteLogSolver(9, 998244353).order(), 998244352 / 2);
+  BOOST_CHECK_EQUAL(DiscreteLogSolver(3, 0xFFFFFFFB).logarithm(1431655764), 2147483644);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
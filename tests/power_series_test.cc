@@ -0,0 +1,119 @@
+// Jakub Staroń, 2016-2017
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include "numeric/power_series.h"
+
+using namespace pcl;
+using namespace pcl::numeric;
+
+namespace {
+
+using field = prime_field<kNttPrime1>;
+using series = std::vector<field>;
+
+series random_series(size_t size, field head) {
+  series result = {head};
+  for (auto i: range<size_t>(1, size))
+    result.push_back(Random32());
+  return result;
+}
+
+series truncated_product(const series& a, const series& b, size_t n) {
+  auto result = numeric::detail::naive_convolution(a, b);
+  result.resize(n);
+  return result;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(power_series_suite)
+
+BOOST_AUTO_TEST_CASE(inverse_test) {
+  BOOST_CHECK(SeriesInverse(series{1, -1}, 4) == series({1, 1, 1, 1}));
+  BOOST_CHECK(SeriesInverse(series{2}, 3) == series({inverse(field(2)), 0, 0}));
+  BOOST_CHECK(SeriesInverse(series{5}, 0).empty());
+  BOOST_CHECK_THROW(SeriesInverse(series{0, 1}, 3), std::invalid_argument);
+  BOOST_CHECK_THROW(SeriesInverse(series(), 3), std::invalid_argument);
+
+  for (size_t n: {1, 5, 32, 33, 100, 1000, 4096}) {
+    const auto a = random_series(n / 2 + 1, Random32() % 1000 + 1);
+    const auto b = SeriesInverse(a, n);
+    BOOST_REQUIRE_EQUAL(b.size(), n);
+    series one(n);
+    one[0] = 1;
+    BOOST_CHECK(truncated_product(a, b, n) == one);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(log_exp_test) {
+  // exp(x) = sum x^k / k!
+  const auto e = SeriesExp(series{0, 1}, 10);
+  field factorial = 1;
+  for (auto k: range<uint32>(0, 10)) {
+    BOOST_CHECK_EQUAL(e[k] * factorial, 1);
+    factorial *= k + 1;
+  }
+  BOOST_CHECK(SeriesExp(series(), 3) == series({1, 0, 0}));
+  BOOST_CHECK(SeriesLog(series{1}, 3) == series({0, 0, 0}));
+  // log(1 + x) = sum (-1)^(k+1) x^k / k
+  const auto l = SeriesLog(series{1, 1}, 6);
+  for (auto k: range<uint32>(1, 6))
+    BOOST_CHECK_EQUAL(l[k] * k, (k % 2 == 1)? 1 : -1);
+  BOOST_CHECK_THROW(SeriesLog(series{2, 1}, 3), std::invalid_argument);
+  BOOST_CHECK_THROW(SeriesExp(series{1, 1}, 3), std::invalid_argument);
+
+  for (size_t n: {2, 31, 64, 1000, 3000}) {
+    const auto a = random_series(n, 0);
+    const auto b = SeriesExp(a, n);
+    BOOST_REQUIRE_EQUAL(b.size(), n);
+    BOOST_CHECK(SeriesLog(b, n) == a);
+    // exp(a)' = a' exp(a)
+    series da(n), db(n);
+    for (auto i: range<size_t>(1, n)) {
+      da[i - 1] = a[i] * i;
+      db[i - 1] = b[i] * i;
+    }
+    auto expected = truncated_product(da, b, n - 1);
+    db.resize(n - 1);
+    BOOST_CHECK(expected == db);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(sqrt_test) {
+  BOOST_CHECK(SeriesSqrt(series{1, 2, 1}, 4) == series({1, 1, 0, 0}));
+  BOOST_CHECK_THROW(SeriesSqrt(series{4, 1}, 3), std::invalid_argument);
+
+  for (size_t n: {1, 7, 100, 2000}) {
+    const auto a = random_series(n, 1);
+    const auto b = SeriesSqrt(a, n);
+    BOOST_REQUIRE_EQUAL(b.size(), n);
+    BOOST_CHECK(truncated_product(b, b, n) == a);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(division_test) {
+  const auto simple = PolynomialDivision(series{1, 2, 1}, series{1, 1});
+  BOOST_CHECK(simple.first == series({1, 1}));
+  BOOST_CHECK(simple.second == series({0}));
+  const auto shorter = PolynomialDivision(series{1, 2}, series{1, 2, 3, 4});
+  BOOST_CHECK(shorter.first.empty());
+  BOOST_CHECK(shorter.second == series({1, 2, 0}));
+  BOOST_CHECK_THROW(PolynomialDivision(series{1, 2}, series{1, 0}), std::invalid_argument);
+  BOOST_CHECK_THROW(PolynomialDivision(series{1, 2}, series()), std::invalid_argument);
+
+  for (auto sizes: std::vector<std::pair<size_t, size_t>>{{10, 1}, {100, 3}, {100, 99}, {3000, 1000}}) {
+    const auto a = random_series(sizes.first, Random32());
+    const auto b = random_series(sizes.second, Random32());
+    const auto result = PolynomialDivision(a, b);
+    BOOST_REQUIRE_EQUAL(result.first.size(), a.size() - b.size() + 1);
+    BOOST_REQUIRE_EQUAL(result.second.size(), b.size() - 1);
+    auto restored = numeric::detail::naive_convolution(b, result.first);
+    for (auto i: range<size_t>(0, result.second.size()))
+      restored[i] += result.second[i];
+    BOOST_CHECK(restored == a);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
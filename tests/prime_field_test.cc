@@ -4,6 +4,7 @@
 #define BOOST_TEST_MAIN
 #include <boost/test/unit_test.hpp>
 #include "numeric.h"
+#include "numeric/montgomery_field.h"
 #include "numeric/prime_field.h"
 #include "io.h"
 
@@ -295,4 +296,50 @@ BOOST_AUTO_TEST_CASE(equality_test) {
   }
 }
 
+template <uint32 prime>
+void check_montgomery_field() {
+  using field = numeric::prime_field<prime>;
+  using montgomery = numeric::montgomery_field<prime>;
+  for (auto i: range<uint32>(0, 1000)) {
+    const int64 a = int64(Random64()), b = int64(Random64());
+    const field x(a), y(b);
+    const montgomery u(a), v(b);
+    BOOST_CHECK_EQUAL(u.value(), x.value());
+    BOOST_CHECK_EQUAL((u + v).value(), (x + y).value());
+    BOOST_CHECK_EQUAL((u - v).value(), (x - y).value());
+    BOOST_CHECK_EQUAL((u * v).value(), (x * y).value());
+    BOOST_CHECK_EQUAL(power(u, uint64(b)).value(), power(x, uint64(b)).value());
+    if (y != 0)
+      BOOST_CHECK_EQUAL((u / v).value(), (x / y).value());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(montgomery_field_test) {
+  check_montgomery_field<3>();
+  check_montgomery_field<1000000007>();
+  check_montgomery_field<uint32_prime1>();
+  check_montgomery_field<uint32_prime2>();
+
+  using field = numeric::montgomery_field<uint32_prime1>;
+  constexpr field a = 5, b = -1;
+  static_assert((a * b).value() == uint32_prime1 - 5, "montgomery_field is not constexpr");
+  static_assert((a + b) == 4 && (b - a) == -6, "montgomery_field is not constexpr");
+  BOOST_CHECK_EQUAL(inverse(field(5)), 3435973833u);
+  BOOST_CHECK_THROW(inverse(field(0)), std::runtime_error);
+
+  field c(2);
+  c += 3;
+  c *= c;
+  c -= 1;
+  c /= 8;
+  BOOST_CHECK_EQUAL(c, 3);
+
+  std::ostringstream output;
+  output << field(-1);
+  BOOST_CHECK_EQUAL(output.str(), std::to_string(uint32_prime1 - 1));
+  std::istringstream input("-2");
+  input >> c;
+  BOOST_CHECK_EQUAL(c, uint32_prime1 - 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
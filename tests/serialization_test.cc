@@ -0,0 +1,187 @@
+// Jakub Staroń, 2016-2017
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+#include "io/serialization.h"
+#include "io/mapped_file.h"
+#include "data_structures/range_minimum_query.h"
+#include "data_structures/power_tree.h"
+#include "data_structures/van_emde_boas_set.h"
+#include "graph/graph.h"
+#include "numeric/number_theory.h"
+#include "text_algorithms/hasher.h"
+
+using namespace pcl;
+
+BOOST_AUTO_TEST_SUITE(serialization_suite)
+
+BOOST_AUTO_TEST_CASE(format_test) {
+  std::ostringstream stream;
+  {
+    BinaryWriter writer(stream);
+    writer.write(uint32(0x01020304)).write(int16(-2));
+  }
+  const std::string expected("PCLB\x01\x00\x00\x00\x04\x03\x02\x01\xfe\xff", 14);
+  BOOST_CHECK(stream.str() == expected);
+
+  std::istringstream input(expected);
+  BinaryReader reader(input);
+  BOOST_CHECK_EQUAL(reader.read<uint32>(), 0x01020304u);
+  BOOST_CHECK_EQUAL(reader.read<int16>(), -2);
+  BOOST_CHECK_THROW(reader.read<uint8>(), std::runtime_error);
+
+  std::istringstream invalid("PCLX\x01\x00\x00\x00");
+  BOOST_CHECK_THROW(BinaryReader{invalid}, std::runtime_error);
+  std::istringstream version(std::string("PCLB\x02\x00\x00\x00", 8));
+  BOOST_CHECK_THROW(BinaryReader{version}, std::runtime_error);
+
+  // Corrupted sizes must not be used to allocate memory.
+  const std::string header("PCLB\x01\x00\x00\x00", 8);
+  const std::string huge_vector = header + std::string("\x00\x00\x00\x00\x00\x01\x00\x00\x04\x00\x00\x00", 12);
+  const std::string huge_string = header + std::string("\x00\x00\x00\x00\x00\x00\x00\x40", 8) + "abc";
+  BinaryReader vector_memory(huge_vector.data(), huge_vector.data() + huge_vector.size());
+  BOOST_CHECK_THROW(vector_memory.read<std::vector<uint32>>(), std::runtime_error);
+  BinaryReader string_memory(huge_string.data(), huge_string.data() + huge_string.size());
+  BOOST_CHECK_THROW(string_memory.read<std::string>(), std::runtime_error);
+  BinaryReader bits_memory(huge_string.data(), huge_string.data() + huge_string.size());
+  BOOST_CHECK_THROW(bits_memory.read<bit_vector>(), std::runtime_error);
+  std::istringstream vector_stream(huge_vector);
+  BOOST_CHECK_THROW(BinaryReader(vector_stream).read<std::vector<uint32>>(), std::runtime_error);
+  std::istringstream string_stream(huge_string);
+  BOOST_CHECK_THROW(BinaryReader(string_stream).read<std::string>(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(containers_test) {
+  std::vector<uint64> numbers = {1, 2, 3, std::numeric_limits<uint64>::max()};
+  std::vector<uint32_pair> pairs = {{1, 2}, {3, 4}};
+  std::vector<std::string> strings = {"Ala", "", "kota"};
+  std::vector<hash::hash_type> hashes = {{1, 2}, {3, 4}};
+  bit_vector sieve = numeric::Sieve(1000);
+  std::vector<std::vector<int>> empty;
+
+  std::ostringstream stream;
+  BinaryWriter writer(stream);
+  writer.write(numbers).write(pairs).write(strings).write(hashes).write(sieve).write(empty);
+
+  const std::string data = stream.str();
+  BinaryReader reader(data.data(), data.data() + data.size());
+  BOOST_CHECK(reader.read<std::vector<uint64>>() == numbers);
+  BOOST_CHECK(reader.read<std::vector<uint32_pair>>() == pairs);
+  BOOST_CHECK(reader.read<std::vector<std::string>>() == strings);
+  BOOST_CHECK(reader.read<std::vector<hash::hash_type>>() == hashes);
+  BOOST_CHECK(reader.read<bit_vector>() == sieve);
+  BOOST_CHECK(reader.read<std::vector<std::vector<int>>>() == empty);
+  BOOST_CHECK_THROW(reader.read<uint8>(), std::runtime_error);
+
+  BinaryReader mismatch(data.data(), data.data() + data.size());
+  BOOST_CHECK_THROW(mismatch.read<std::vector<uint32>>(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(data_structures_test) {
+  std::vector<int> values;
+  for (auto i: range<int>(0, 1000))
+    values.push_back(int(Random32() % 1000));
+  RangeMinimumQuery<int> rmq(values.begin(), values.end());
+  PowerTree<int64> tree(100);
+  tree.insert(5, 7);
+  tree.insert(50, -3);
+  VanEmdeBoasSet<16> set;
+  set.insert(4);
+  set.insert(1000);
+  const std::string text = "abracadabra";
+  Hasher hasher(text.begin(), text.end());
+
+  std::FILE* file = std::tmpfile();
+  BOOST_REQUIRE(file != nullptr);
+  {
+    std::ostringstream stream;
+    BinaryWriter writer(stream);
+    writer.write(rmq).write(tree).write(set).write(hasher);
+    const std::string data = stream.str();
+    std::fwrite(data.data(), 1, data.size(), file);
+    std::fflush(file);
+  }
+
+  MappedFile mapped(fileno(file));
+  BinaryReader reader(mapped.begin(), mapped.end());
+  auto loaded_rmq = reader.read<RangeMinimumQuery<int>>();
+  auto loaded_tree = reader.read<PowerTree<int64>>();
+  auto loaded_set = reader.read<VanEmdeBoasSet<16>>();
+  auto loaded_hasher = reader.read<Hasher>();
+  std::fclose(file);
+
+  BOOST_REQUIRE_EQUAL(loaded_rmq.size(), rmq.size());
+  for (auto i: range<uint32>(0, 100)) {
+    const uint32 first = Random32() % 1000;
+    const uint32 last = first + Random32() % (1000 - first);
+    BOOST_CHECK_EQUAL(loaded_rmq.minimum(first, last), rmq.minimum(first, last));
+  }
+
+  BOOST_CHECK_EQUAL(loaded_tree.size(), 100);
+  BOOST_CHECK_EQUAL(loaded_tree.query(0, 99), 4);
+  BOOST_CHECK_EQUAL(loaded_tree.query(6, 99), -3);
+
+  BOOST_CHECK_EQUAL(loaded_set.size(), 2);
+  BOOST_CHECK(loaded_set.find(4));
+  BOOST_CHECK(loaded_set.find(1000));
+  BOOST_CHECK_EQUAL(loaded_set.successor(4), 1000);
+
+  BOOST_CHECK(loaded_hasher.getHash(0, 4) == hasher.getHash(7, 4));
+  BOOST_CHECK(loaded_hasher.getHash(1, 5) == hasher.getHash(1, 5));
+}
+
+BOOST_AUTO_TEST_CASE(corrupted_range_minimum_query_test) {
+  const std::vector<int> values = {5, 3, 4, 1, 2};
+  const std::vector<uint32> level0 = {0, 1, 2, 3, 4}, level1 = {1, 1, 3, 3}, level2 = {3, 3};
+  auto load = [&values](uint32 levels, const std::vector<std::vector<uint32>>& segments) {
+    std::ostringstream stream;
+    BinaryWriter writer(stream);
+    writer.write(values).write(levels);
+    for (const auto& segment: segments)
+      writer.write(segment);
+    const std::string data = stream.str();
+    BinaryReader reader(data.data(), data.data() + data.size());
+    return reader.read<RangeMinimumQuery<int>>();
+  };
+
+  auto rmq = load(3, {level0, level1, level2});
+  BOOST_CHECK_EQUAL(rmq.minimum(0, 4), 3);
+  BOOST_CHECK_EQUAL(rmq.minimum(0, 2), 1);
+  BOOST_CHECK_THROW(load(2, {level0, level1}), std::runtime_error);
+  BOOST_CHECK_THROW(load(4, {level0, level1, level2, {3}}), std::runtime_error);
+  BOOST_CHECK_THROW(load(3, {level0, level1, {3}}), std::runtime_error);
+  BOOST_CHECK_THROW(load(3, {level0, {1, 1, 3, 5}, level2}), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(graph_test) {
+  graph::UndirectedGraph graph(4);
+  graph.add_edge(0, 1);
+  graph.add_edge(1, 2);
+  graph.add_edge(3, 1);
+
+  std::ostringstream stream;
+  BinaryWriter writer(stream);
+  writer.write(graph);
+  std::istringstream input(stream.str());
+  BinaryReader reader(input);
+  auto loaded = reader.read<graph::UndirectedGraph>();
+
+  BOOST_REQUIRE_EQUAL(loaded.vertices_count(), 4);
+  BOOST_REQUIRE_EQUAL(loaded.edges_count(), 3);
+  for (auto v: range<graph::id_type>(0, 4)) {
+    std::vector<graph::id_type> expected, result;
+    for (const auto& edge: graph.edges_from(v))
+      expected.push_back(edge.pass_from(v));
+    for (const auto& edge: loaded.edges_from(v))
+      result.push_back(edge.pass_from(v));
+    BOOST_CHECK(result == expected);
+  }
+
+  std::string corrupted = stream.str();
+  corrupted.replace(corrupted.size() - sizeof(graph::id_type), sizeof(graph::id_type), sizeof(graph::id_type), '\x7f');
+  BinaryReader corrupted_reader(corrupted.data(), corrupted.data() + corrupted.size());
+  BOOST_CHECK_THROW(corrupted_reader.read<graph::UndirectedGraph>(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -2,6 +2,7 @@
 // Jakub Staroń, 2016-2017
 
 #include "hash.h"
+#include "io/serialization.h"
 
 namespace pcl {
 
@@ -54,7 +55,8 @@ public:
 
   Hasher(Hasher&& other):
       inverses_(std::move(other.inverses_)),
-      hashes_(std::move(other.hashes_)) { }
+      hashes_(std::move(other.hashes_)),
+      size_(other.size_) { }
 
   /**
    * Returns hash of subsequence.
@@ -64,7 +66,29 @@ public:
     return hash::multiply(tmp, inverses_[begin]);
   }
 
+  /**
+   * Writes preprocessed prefix hashes and inverses, see BinaryWriter.
+   */
+  void serialize(BinaryWriter& writer) const {
+    writer.write(size_).write(inverses_).write(hashes_);
+  }
+
+  /**
+   * Reads hasher written by serialize without preprocessing.
+   */
+  static Hasher deserialize(BinaryReader& reader) {
+    Hasher result;
+    result.size_ = reader.read<index_type>();
+    result.inverses_ = reader.read<std::vector<hash_type>>();
+    result.hashes_ = reader.read<std::vector<hash_type>>();
+    if (result.inverses_.size() != result.size_ + 1 || result.hashes_.size() != result.size_ + 1)
+      throw std::runtime_error("Hasher - invalid serialized data");
+    return result;
+  }
+
 private:
+  Hasher(): size_(0) { }
+
   void preprocessInverses() {
     inverses_.resize(size_ + 1);
     inverses_[0] = hash::one;
@@ -0,0 +1,90 @@
+#pragma once
+// Jakub Staroń, 2016-2017
+
+#include "headers.h"
+#include "operators.h"
+
+namespace pcl {
+
+/**
+ * Non-owning view of contiguous sequence of characters,
+ * similar to C++17 std::string_view.
+ *
+ * Slice does not copy data, so viewed memory must
+ * outlive it.
+ *
+ * Example:
+ * <pre>
+ * std::string text = "Ala ma kota";
+ * string_slice slice(text.data(), 3); // "Ala"
+ * </pre>
+ */
+class string_slice {
+public:
+  using value_type = char;
+  using size_type = size_t;
+  using iterator = const char*;
+  using const_iterator = const char*;
+
+  constexpr string_slice():
+      data_(nullptr), size_(0) { }
+
+  constexpr string_slice(const char* data, size_type size):
+      data_(data), size_(size) { }
+
+  string_slice(const char* text):
+      data_(text), size_(std::strlen(text)) { }
+
+  string_slice(const std::string& text):
+      data_(text.data()), size_(text.size()) { }
+
+  constexpr const char* data() const {
+    return data_;
+  }
+
+  constexpr size_type size() const {
+    return size_;
+  }
+
+  constexpr bool empty() const {
+    return size_ == 0;
+  }
+
+  constexpr iterator begin() const {
+    return data_;
+  }
+
+  constexpr iterator end() const {
+    return data_ + size_;
+  }
+
+  constexpr char operator[](size_type i) const {
+    return data_[i];
+  }
+
+  /**
+   * Returns copy of viewed characters.
+   */
+  std::string str() const {
+    return std::string(data_, size_);
+  }
+
+  friend bool operator==(const string_slice& lhs, const string_slice& rhs) {
+    return lhs.size_ == rhs.size_ &&
+        (lhs.size_ == 0 || std::memcmp(lhs.data_, rhs.data_, lhs.size_) == 0);
+  }
+
+  friend bool operator<(const string_slice& lhs, const string_slice& rhs) {
+    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+
+  friend std::ostream& operator<<(std::ostream& stream, const string_slice& slice) {
+    return stream.write(slice.data_, slice.size_);
+  }
+
+private:
+  const char* data_;
+  size_type size_;
+};
+
+} // namespace pcl